@@ -307,4 +307,96 @@ typedef union _CPUID_INFO
         };
     } F07_01;
 
+    /* 15H: Time Stamp Counter and Nominal Core Crystal Clock Information */
+    struct
+    {
+        /* Eax */
+        unsigned int Denominator;           /* Denominator of the TSC/"core crystal clock" ratio */
+        /* Ebx */
+        unsigned int Numerator;             /* Numerator of the TSC/"core crystal clock" ratio, 0 if not enumerated */
+        /* Ecx */
+        unsigned int CrystalClockFrequency; /* Nominal frequency of the core crystal clock in Hz, 0 if not enumerated */
+        /* Edx */
+        unsigned int ReservedBits0;
+    } F15_00;
+
+    /* 16H: Processor Frequency Information */
+    struct
+    {
+        /* Eax */
+        struct
+        {
+            unsigned int BaseFrequency : 16;   /* 00-15 Processor Base Frequency (in MHz) */
+            unsigned int ReservedBits0 : 16;   /* 16-31 Reserved */
+        };
+        /* Ebx */
+        struct
+        {
+            unsigned int MaximumFrequency : 16;    /* 00-15 Maximum Frequency (in MHz) */
+            unsigned int ReservedBits1 : 16;       /* 16-31 Reserved */
+        };
+        /* Ecx */
+        struct
+        {
+            unsigned int BusFrequency : 16;    /* 00-15 Bus (Reference) Frequency (in MHz) */
+            unsigned int ReservedBits2 : 16;   /* 16-31 Reserved */
+        };
+        /* Edx */
+        unsigned int ReservedBits3;
+    } F16_00;
+
+    /* 80000000H-80000007H: Extended Function CPUID Information */
+    struct
+    {
+        /* Eax */
+        unsigned int MaxInputValue;         /* Maximum Input Value for Extended Function CPUID Information */
+        /* Ebx, Ecx, Edx */
+        unsigned int ReservedBits0[3];
+    } F80000000_00;
+
+    struct
+    {
+        /* Eax */
+        unsigned int ExtendedSignature;
+        /* Ebx */
+        unsigned int ReservedBits0;
+        /* Ecx */
+        struct
+        {
+            unsigned int LAHF_SAHF : 1;        /* 00 LAHF/SAHF available in 64-bit mode */
+            unsigned int ReservedBits1 : 4;    /* 01-04 Reserved */
+            unsigned int LZCNT : 1;            /* 05 LZCNT */
+            unsigned int ReservedBits2 : 2;    /* 06-07 Reserved */
+            unsigned int PREFETCHW : 1;        /* 08 PREFETCHW */
+            unsigned int ReservedBits3 : 23;   /* 09-31 Reserved */
+        };
+        /* Edx */
+        struct
+        {
+            unsigned int ReservedBits4 : 11;   /* 00-10 Reserved */
+            unsigned int SYSCALL : 1;          /* 11 SYSCALL/SYSRET */
+            unsigned int ReservedBits5 : 8;    /* 12-19 Reserved */
+            unsigned int NX : 1;               /* 20 Execute Disable Bit */
+            unsigned int ReservedBits6 : 5;    /* 21-25 Reserved */
+            unsigned int Page1GB : 1;          /* 26 1-GByte pages */
+            unsigned int RDTSCP : 1;           /* 27 RDTSCP and IA32_TSC_AUX */
+            unsigned int ReservedBits7 : 1;    /* 28 Reserved */
+            unsigned int Intel64 : 1;          /* 29 Intel 64 Architecture */
+            unsigned int ReservedBits8 : 2;    /* 30-31 Reserved */
+        };
+    } F80000001_00;
+
+    struct
+    {
+        /* Eax, Ebx, Ecx */
+        unsigned int ReservedBits0[3];
+        /* Edx */
+        struct
+        {
+            unsigned int ReservedBits1 : 8;    /* 00-07 Reserved */
+            unsigned int InvariantTSC : 1;     /* 08 Invariant TSC */
+            unsigned int ReservedBits2 : 23;   /* 09-31 Reserved */
+        };
+    } F80000007_00;
+
 } CPUID_INFO, *PCPUID_INFO;
@@ -0,0 +1,522 @@
+﻿//------------------------------------------------------------------------------
+// <auto-generated>
+//     This code was generated by TypeInfoGenerator in KNSoft.SMBIOS project
+//     https://github.com/KNSoft/KNSoft.SMBIOS
+//     Do not change this file manually
+// </auto-generated>
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "SMBIOS.h"
+#include "SmbiosCompiled.h"
+
+SMBIOS_DEFINE_COMPILED_VISIT(0)
+{
+    SMBIOS_COMPILED_VISIT_BEGIN(0);
+    SMBIOS_DECODE_FIELD_STRING(0, 0, "Vendor", Vendor);
+    SMBIOS_DECODE_FIELD_STRING(1, 0, "Firmware Version", Version);
+    SMBIOS_DECODE_FIELD_UINT(2, 0, "BIOS Starting Address Segment", BIOSStartingAddressSegment);
+    SMBIOS_DECODE_FIELD_STRING(3, 0, "Firmware Release Date", ReleaseDate);
+    SMBIOS_DECODE_FIELD_UINT(4, 0, "Firmware ROM Size", ROMSize);
+    SMBIOS_DECODE_FIELD_UINT(5, 0, "Firmware Characteristics", Characteristics.Value);
+    SMBIOS_DECODE_FIELD_BIT(6, "Reserved", 0);
+    SMBIOS_DECODE_FIELD_BIT(7, "Reserved", 1);
+    SMBIOS_DECODE_FIELD_BIT(8, "Unknown", 2);
+    SMBIOS_DECODE_FIELD_BIT(9, "Firmware Characteristics are not supported", 3);
+    SMBIOS_DECODE_FIELD_BIT(10, "ISA is supported", 4);
+    SMBIOS_DECODE_FIELD_BIT(11, "MCA is supported", 5);
+    SMBIOS_DECODE_FIELD_BIT(12, "EISA is supported", 6);
+    SMBIOS_DECODE_FIELD_BIT(13, "PCI is supported", 7);
+    SMBIOS_DECODE_FIELD_BIT(14, "PC card (PCMCIA) is supported", 8);
+    SMBIOS_DECODE_FIELD_BIT(15, "Plug and Play is supported", 9);
+    SMBIOS_DECODE_FIELD_BIT(16, "APM is supported", 10);
+    SMBIOS_DECODE_FIELD_BIT(17, "Firmware is upgradeable (Flash)", 11);
+    SMBIOS_DECODE_FIELD_BIT(18, "Firmware shadowing is allowed", 12);
+    SMBIOS_DECODE_FIELD_BIT(19, "VL-VESA is supported", 13);
+    SMBIOS_DECODE_FIELD_BIT(20, "ESCD support is available", 14);
+    SMBIOS_DECODE_FIELD_BIT(21, "Boot from CD is supported", 15);
+    SMBIOS_DECODE_FIELD_BIT(22, "Selectable boot is supported", 16);
+    SMBIOS_DECODE_FIELD_BIT(23, "Firmware ROM is socketed (e.g., PLCC or SOP socket)", 17);
+    SMBIOS_DECODE_FIELD_BIT(24, "Boot from PC card (PCMCIA) is supported", 18);
+    SMBIOS_DECODE_FIELD_BIT(25, "EDD specification is supported", 19);
+    SMBIOS_DECODE_FIELD_BIT(26, "Int 13h — Japanese floppy for NEC 9800 1.2 MB (3.5\", 1K bytes/sector, 360 RPM) is supported", 20);
+    SMBIOS_DECODE_FIELD_BIT(27, "Int 13h — Japanese floppy for Toshiba 1.2 MB (3.5\", 360 RPM) is supported", 21);
+    SMBIOS_DECODE_FIELD_BIT(28, "Int 13h — 5.25\" / 360 KB floppy services are supported", 22);
+    SMBIOS_DECODE_FIELD_BIT(29, "Int 13h — 5.25\" / 1.2 MB floppy services are supported", 23);
+    SMBIOS_DECODE_FIELD_BIT(30, "Int 13h — 3.5\" / 720 KB floppy services are supported", 24);
+    SMBIOS_DECODE_FIELD_BIT(31, "Int 13h — 3.5\" / 2.88 MB floppy services are supported", 25);
+    SMBIOS_DECODE_FIELD_BIT(32, "Int 5h, print screen service is supported", 26);
+    SMBIOS_DECODE_FIELD_BIT(33, "Int 9h, 8042 keyboard services are supported", 27);
+    SMBIOS_DECODE_FIELD_BIT(34, "Int 14h, serial services are supported", 28);
+    SMBIOS_DECODE_FIELD_BIT(35, "Int 17h, printer services are supported", 29);
+    SMBIOS_DECODE_FIELD_BIT(36, "Int 10h, CGA/Mono Video Services are supported", 30);
+    SMBIOS_DECODE_FIELD_BIT(37, "NEC PC-98", 31);
+    SMBIOS_DECODE_BIT_FIELD(38, "Reserved for platform firmware vendor", 32, 16, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_BIT_FIELD(39, "Reserved for system vendor", 48, 16, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_UINT(40, 0, "Firmware Characteristics Extension Byte 1", CharacteristicsExtensionByte1.Value);
+    SMBIOS_DECODE_FIELD_BIT(41, "ACPI is supported", 0);
+    SMBIOS_DECODE_FIELD_BIT(42, "USB Legacy is supported", 1);
+    SMBIOS_DECODE_FIELD_BIT(43, "AGP is supported", 2);
+    SMBIOS_DECODE_FIELD_BIT(44, "I2O boot is supported", 3);
+    SMBIOS_DECODE_FIELD_BIT(45, "LS-120 SuperDisk boot is supported", 4);
+    SMBIOS_DECODE_FIELD_BIT(46, "ATAPI ZIP drive boot is supported", 5);
+    SMBIOS_DECODE_FIELD_BIT(47, "1394 boot is supported", 6);
+    SMBIOS_DECODE_FIELD_BIT(48, "Smart battery is supported", 7);
+    SMBIOS_DECODE_FIELD_UINT(49, 0, "Firmware Characteristics Extension Byte 2", CharacteristicsExtensionByte2.Value);
+    SMBIOS_DECODE_FIELD_BIT(50, "BIOS Boot Specification is supported", 0);
+    SMBIOS_DECODE_FIELD_BIT(51, "Function key-initiated network service boot is supported", 1);
+    SMBIOS_DECODE_FIELD_BIT(52, "Enable targeted content distribution", 2);
+    SMBIOS_DECODE_FIELD_BIT(53, "UEFI Specification is supported", 3);
+    SMBIOS_DECODE_FIELD_BIT(54, "SMBIOS table describes a virtual machine", 4);
+    SMBIOS_DECODE_FIELD_BIT(55, "Manufacturing mode is supported", 5);
+    SMBIOS_DECODE_FIELD_BIT(56, "Manufacturing mode is enabled", 6);
+    SMBIOS_DECODE_FIELD_BIT(57, "Reserved", 7);
+    SMBIOS_DECODE_FIELD_UINT(58, 0, "Platform Firmware Major Release", MajorRelease);
+    SMBIOS_DECODE_FIELD_UINT(59, 0, "Platform Firmware Minor Release", MinorRelease);
+    SMBIOS_DECODE_FIELD_UINT(60, 0, "Embedded Controller Firmware Major Release", ECFirmwareMajorRelease);
+    SMBIOS_DECODE_FIELD_UINT(61, 0, "Embedded Controller Firmware Minor Release", ECFirmwareMinorRelease);
+    SMBIOS_DECODE_FIELD_UINT(62, 0, "Extended Firmware ROM Size", ExtendedROMSize.Value);
+    SMBIOS_DECODE_BIT_FIELD(63, "Size", 0, 14, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_BIT_FIELD(64, "Unit", 14, 2, SmbiosDataTypeEnum, SMBIOS_FIELD_ENUM_VALUES(SmbiosPlatformFirmwareExtendedRomsizeUnitEnum));
+    SMBIOS_COMPILED_VISIT_END();
+}
+
+SMBIOS_DEFINE_COMPILED_VISIT(4)
+{
+    SMBIOS_COMPILED_VISIT_BEGIN(4);
+    SMBIOS_DECODE_FIELD_STRING(0, 4, "Socket Designation", SocketDesignation);
+    SMBIOS_DECODE_FIELD_ENUM(1, 4, "Processor Type", Type, SmbiosProcessorTypeEnum);
+    SMBIOS_DECODE_FIELD_ENUM(2, 4, "Processor Family", Family, SmbiosProcessorFamilyEnum);
+    SMBIOS_DECODE_FIELD_STRING(3, 4, "Processor Manufacturer", Manufacturer);
+    SMBIOS_DECODE_FIELD_UINT(4, 4, "Processor ID", ID);
+    SMBIOS_DECODE_FIELD_STRING(5, 4, "Processor Version", Version);
+    SMBIOS_DECODE_FIELD_UINT(6, 4, "Voltage", Voltage.Value);
+    SMBIOS_DECODE_FIELD_BIT(7, "5V", 0);
+    SMBIOS_DECODE_FIELD_BIT(8, "3.3V", 1);
+    SMBIOS_DECODE_FIELD_BIT(9, "2.9V", 2);
+    SMBIOS_DECODE_FIELD_BIT(10, "Reserved", 3);
+    SMBIOS_DECODE_BIT_FIELD(11, "Reserved", 4, 3, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(12, "Not Legacy Mode, this structure is invalid", 7);
+    SMBIOS_DECODE_BIT_FIELD(13, "Current voltage times 10", 0, 7, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(14, "Not Legacy Mode, this structure is valid", 7);
+    SMBIOS_DECODE_FIELD_UINT(15, 4, "External Clock", ExternalClock);
+    SMBIOS_DECODE_FIELD_UINT(16, 4, "Max Speed", MaxSpeed);
+    SMBIOS_DECODE_FIELD_UINT(17, 4, "Current Speed", CurrentSpeed);
+    SMBIOS_DECODE_FIELD_UINT(18, 4, "Status", Status.Value);
+    SMBIOS_DECODE_BIT_FIELD(19, "CPU Status", 0, 3, SmbiosDataTypeEnum, SMBIOS_FIELD_ENUM_VALUES(SmbiosProcessorCpuStatusEnum));
+    SMBIOS_DECODE_BIT_FIELD(20, "Reserved", 3, 3, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(21, "CPU Socket Populated", 6);
+    SMBIOS_DECODE_FIELD_BIT(22, "Reserved", 7);
+    SMBIOS_DECODE_FIELD_ENUM(23, 4, "Processor Upgrade", Upgrade, SmbiosProcessorUpgradeEnum);
+    SMBIOS_DECODE_FIELD_UINT(24, 4, "L1 Cache Handle", L1CacheHandle);
+    SMBIOS_DECODE_FIELD_UINT(25, 4, "L2 Cache Handle", L2CacheHandle);
+    SMBIOS_DECODE_FIELD_UINT(26, 4, "L3 Cache Handle", L3CacheHandle);
+    SMBIOS_DECODE_FIELD_STRING(27, 4, "Serial Number", SerialNumber);
+    SMBIOS_DECODE_FIELD_STRING(28, 4, "Asset Tag", AssetTag);
+    SMBIOS_DECODE_FIELD_STRING(29, 4, "Part Number", PartNumber);
+    SMBIOS_DECODE_FIELD_UINT(30, 4, "Core Count", CoreCount);
+    SMBIOS_DECODE_FIELD_UINT(31, 4, "Core Enabled", CoreEnabled);
+    SMBIOS_DECODE_FIELD_UINT(32, 4, "Thread Count", ThreadCount);
+    SMBIOS_DECODE_FIELD_UINT(33, 4, "Processor Characteristics", Characteristics.Value);
+    SMBIOS_DECODE_FIELD_BIT(34, "Reserved", 0);
+    SMBIOS_DECODE_FIELD_BIT(35, "Unknown", 1);
+    SMBIOS_DECODE_FIELD_BIT(36, "64-bit Capable", 2);
+    SMBIOS_DECODE_FIELD_BIT(37, "Multi-Core", 3);
+    SMBIOS_DECODE_FIELD_BIT(38, "Hardware Thread", 4);
+    SMBIOS_DECODE_FIELD_BIT(39, "Execute Protection", 5);
+    SMBIOS_DECODE_FIELD_BIT(40, "Enhanced Virtualization", 6);
+    SMBIOS_DECODE_FIELD_BIT(41, "Power/Performance Control", 7);
+    SMBIOS_DECODE_FIELD_BIT(42, "128-bit Capable", 8);
+    SMBIOS_DECODE_FIELD_BIT(43, "Arm64 SoC ID", 9);
+    SMBIOS_DECODE_BIT_FIELD(44, "Reserved", 10, 6, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_ENUM(45, 4, "Processor Family 2", Family2, SmbiosProcessorFamily2Enum);
+    SMBIOS_DECODE_FIELD_UINT(46, 4, "Core Count 2", CoreCount2);
+    SMBIOS_DECODE_FIELD_UINT(47, 4, "Core Enabled 2", CoreEnabled2);
+    SMBIOS_DECODE_FIELD_UINT(48, 4, "Thread Count 2", ThreadCount2);
+    SMBIOS_DECODE_FIELD_UINT(49, 4, "Thread Enabled", ThreadEnabled);
+    SMBIOS_DECODE_FIELD_UINT(50, 4, "Socket Type", SocketType);
+    SMBIOS_COMPILED_VISIT_END();
+}
+
+SMBIOS_DEFINE_COMPILED_VISIT(7)
+{
+    SMBIOS_COMPILED_VISIT_BEGIN(7);
+    SMBIOS_DECODE_FIELD_STRING(0, 7, "Socket Designation", SocketDesignation);
+    SMBIOS_DECODE_FIELD_UINT(1, 7, "Cache Configuration", Configuration.Value);
+    SMBIOS_DECODE_BIT_FIELD(2, "Level", 0, 3, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(3, "Socketed", 3);
+    SMBIOS_DECODE_FIELD_BIT(4, "Reserved", 4);
+    SMBIOS_DECODE_BIT_FIELD(5, "Location", 5, 2, SmbiosDataTypeEnum, SMBIOS_FIELD_ENUM_VALUES(SmbiosCacheLocationEnum));
+    SMBIOS_DECODE_FIELD_BIT(6, "Enabled", 7);
+    SMBIOS_DECODE_BIT_FIELD(7, "Operational Mode", 8, 2, SmbiosDataTypeEnum, SMBIOS_FIELD_ENUM_VALUES(SmbiosCacheOperationalModeEnum));
+    SMBIOS_DECODE_BIT_FIELD(8, "Reserved", 10, 6, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_UINT(9, 7, "Maximum Cache Size", MaximumCacheSize.Value);
+    SMBIOS_DECODE_BIT_FIELD(10, "Size", 0, 15, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(11, "64K Granularity", 15);
+    SMBIOS_DECODE_FIELD_UINT(12, 7, "Installed Size", InstalledSize.Value);
+    SMBIOS_DECODE_BIT_FIELD(13, "Size", 0, 15, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(14, "64K Granularity", 15);
+    SMBIOS_DECODE_FIELD_UINT(15, 7, "Supported SRAM Type", SupportedSRAMType.Value);
+    SMBIOS_DECODE_FIELD_BIT(16, "Other", 0);
+    SMBIOS_DECODE_FIELD_BIT(17, "Unknown", 1);
+    SMBIOS_DECODE_FIELD_BIT(18, "Non-Burst", 2);
+    SMBIOS_DECODE_FIELD_BIT(19, "Burst", 3);
+    SMBIOS_DECODE_FIELD_BIT(20, "Pipeline Burst", 4);
+    SMBIOS_DECODE_FIELD_BIT(21, "Synchronous", 5);
+    SMBIOS_DECODE_FIELD_BIT(22, "Asynchronous", 6);
+    SMBIOS_DECODE_BIT_FIELD(23, "Reserved", 7, 9, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_UINT(24, 7, "Current SRAM Type", CurrentSRAMType.Value);
+    SMBIOS_DECODE_FIELD_BIT(25, "Other", 0);
+    SMBIOS_DECODE_FIELD_BIT(26, "Unknown", 1);
+    SMBIOS_DECODE_FIELD_BIT(27, "Non-Burst", 2);
+    SMBIOS_DECODE_FIELD_BIT(28, "Burst", 3);
+    SMBIOS_DECODE_FIELD_BIT(29, "Pipeline Burst", 4);
+    SMBIOS_DECODE_FIELD_BIT(30, "Synchronous", 5);
+    SMBIOS_DECODE_FIELD_BIT(31, "Asynchronous", 6);
+    SMBIOS_DECODE_BIT_FIELD(32, "Reserved", 7, 9, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_UINT(33, 7, "Cache Speed", CacheSpeed);
+    SMBIOS_DECODE_FIELD_ENUM(34, 7, "Error Correction Type", ErrorCorrectionType, SmbiosCacheErrorCorrectionTypeEnum);
+    SMBIOS_DECODE_FIELD_ENUM(35, 7, "System Cache Type", SystemCacheType, SmbiosCacheSystemCacheTypeEnum);
+    SMBIOS_DECODE_FIELD_ENUM(36, 7, "Associativity", Associativity, SmbiosCacheAssociativityEnum);
+    SMBIOS_DECODE_FIELD_UINT(37, 7, "Maximum Cache Size 2", MaximumCacheSize2.Value);
+    SMBIOS_DECODE_BIT_FIELD(38, "Size", 0, 31, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(39, "64K Granularity", 31);
+    SMBIOS_DECODE_FIELD_UINT(40, 7, "Installed Cache Size 2", InstalledCacheSize2.Value);
+    SMBIOS_DECODE_BIT_FIELD(41, "Size", 0, 31, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(42, "64K Granularity", 31);
+    SMBIOS_COMPILED_VISIT_END();
+}
+
+SMBIOS_DEFINE_COMPILED_VISIT(17)
+{
+    SMBIOS_COMPILED_VISIT_BEGIN(17);
+    SMBIOS_DECODE_FIELD_UINT(0, 17, "Physical Memory Array Handle", PhysicalMemoryArrayHandle);
+    SMBIOS_DECODE_FIELD_UINT(1, 17, "Memory Error Information Handle", ErrorInformationHandle);
+    SMBIOS_DECODE_FIELD_UINT(2, 17, "Total Width", TotalWidth);
+    SMBIOS_DECODE_FIELD_UINT(3, 17, "Data Width", DataWidth);
+    SMBIOS_DECODE_FIELD_UINT(4, 17, "Size", Size.Value);
+    SMBIOS_DECODE_BIT_FIELD(5, "Size", 0, 15, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(6, "KB Granularity in KB", 15);
+    SMBIOS_DECODE_FIELD_ENUM(7, 17, "Form Factor", FormFactor, SmbiosMemoryDeviceFormFactorEnum);
+    SMBIOS_DECODE_FIELD_UINT(8, 17, "Device Set", DeviceSet);
+    SMBIOS_DECODE_FIELD_STRING(9, 17, "Device Locator", DeviceLocator);
+    SMBIOS_DECODE_FIELD_STRING(10, 17, "Bank Locator", BankLocator);
+    SMBIOS_DECODE_FIELD_ENUM(11, 17, "Memory Type", Type, SmbiosMemoryDeviceTypeEnum);
+    SMBIOS_DECODE_FIELD_UINT(12, 17, "Type Detail", TypeDetail.Value);
+    SMBIOS_DECODE_FIELD_BIT(13, "Reserved", 0);
+    SMBIOS_DECODE_FIELD_BIT(14, "Other", 1);
+    SMBIOS_DECODE_FIELD_BIT(15, "Unknown", 2);
+    SMBIOS_DECODE_FIELD_BIT(16, "Fast-paged", 3);
+    SMBIOS_DECODE_FIELD_BIT(17, "Static column", 4);
+    SMBIOS_DECODE_FIELD_BIT(18, "Pseudo-static", 5);
+    SMBIOS_DECODE_FIELD_BIT(19, "RAMBUS", 6);
+    SMBIOS_DECODE_FIELD_BIT(20, "Synchronous", 7);
+    SMBIOS_DECODE_FIELD_BIT(21, "CMOS", 8);
+    SMBIOS_DECODE_FIELD_BIT(22, "EDO", 9);
+    SMBIOS_DECODE_FIELD_BIT(23, "Window DRAM", 10);
+    SMBIOS_DECODE_FIELD_BIT(24, "Cache DRAM", 11);
+    SMBIOS_DECODE_FIELD_BIT(25, "Non-volatile", 12);
+    SMBIOS_DECODE_FIELD_BIT(26, "Registered (Buffered)", 13);
+    SMBIOS_DECODE_FIELD_BIT(27, "Unbuffered (Unregistered)", 14);
+    SMBIOS_DECODE_FIELD_BIT(28, "LRDIMM", 15);
+    SMBIOS_DECODE_FIELD_UINT(29, 17, "Speed", Speed);
+    SMBIOS_DECODE_FIELD_STRING(30, 17, "Manufacturer", Manufacturer);
+    SMBIOS_DECODE_FIELD_STRING(31, 17, "Serial Number", SerialNumber);
+    SMBIOS_DECODE_FIELD_STRING(32, 17, "Asset Tag", AssetTag);
+    SMBIOS_DECODE_FIELD_STRING(33, 17, "Part Number", PartNumber);
+    SMBIOS_DECODE_FIELD_UINT(34, 17, "Attributes", Attributes.Value);
+    SMBIOS_DECODE_BIT_FIELD(35, "Rank", 0, 4, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_BIT_FIELD(36, "Reserved", 4, 4, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_UINT(37, 17, "Extended Size", ExtendedSize.Value);
+    SMBIOS_DECODE_BIT_FIELD(38, "Size in MB", 0, 31, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_BIT(39, "Reserved", 31);
+    SMBIOS_DECODE_FIELD_UINT(40, 17, "Configured Memory Speed", ConfiguredMemorySpeed);
+    SMBIOS_DECODE_FIELD_UINT(41, 17, "Minimum voltage", MinimumVoltage);
+    SMBIOS_DECODE_FIELD_UINT(42, 17, "Maximum voltage", MaximumVoltage);
+    SMBIOS_DECODE_FIELD_UINT(43, 17, "Configured voltage", ConfiguredVoltage);
+    SMBIOS_DECODE_FIELD_ENUM(44, 17, "Memory Technology", Technology, SmbiosMemoryDeviceTechnologyEnum);
+    SMBIOS_DECODE_FIELD_UINT(45, 17, "Memory Operating Mode Capability", OperatingModeCapability.Value);
+    SMBIOS_DECODE_FIELD_BIT(46, "Reserved", 0);
+    SMBIOS_DECODE_FIELD_BIT(47, "Other", 1);
+    SMBIOS_DECODE_FIELD_BIT(48, "Unknown", 2);
+    SMBIOS_DECODE_FIELD_BIT(49, "Volatile memory", 3);
+    SMBIOS_DECODE_FIELD_BIT(50, "Byte-accessible persistent memory", 4);
+    SMBIOS_DECODE_FIELD_BIT(51, "Block-accessible persistent memory", 5);
+    SMBIOS_DECODE_BIT_FIELD(52, "Reserved", 6, 10, SmbiosDataTypeUInt);
+    SMBIOS_DECODE_FIELD_STRING(53, 17, "Firmware Version", FirmwareVersion);
+    SMBIOS_DECODE_FIELD_UINT(54, 17, "Module Manufacturer ID", ModuleManufacturerID);
+    SMBIOS_DECODE_FIELD_UINT(55, 17, "Module Product ID", ModuleProductID);
+    SMBIOS_DECODE_FIELD_UINT(56, 17, "Memory Subsystem Controller Manufacturer ID", SubsystemControllerManufacturerID);
+    SMBIOS_DECODE_FIELD_UINT(57, 17, "Memory Subsystem Controller Product ID", SubsystemControllerProductID);
+    SMBIOS_DECODE_FIELD_UINT(58, 17, "Non-volatile Size", NonVolatileSize);
+    SMBIOS_DECODE_FIELD_UINT(59, 17, "Volatile Size", VolatileSize);
+    SMBIOS_DECODE_FIELD_UINT(60, 17, "Cache Size", CacheSize);
+    SMBIOS_DECODE_FIELD_UINT(61, 17, "Logical Size", LogicalSize);
+    SMBIOS_DECODE_FIELD_UINT(62, 17, "Extended Speed", ExtendedSpeed);
+    SMBIOS_DECODE_FIELD_UINT(63, 17, "Extended Configured Memory Speed", ExtendedConfiguredSpeed);
+    SMBIOS_DECODE_FIELD_UINT(64, 17, "PMIC0 Manufacturer ID", PMIC0ManufacturerID);
+    SMBIOS_DECODE_FIELD_UINT(65, 17, "PMIC0 Revision Number", PMIC0RevisionNumber);
+    SMBIOS_DECODE_FIELD_UINT(66, 17, "RCD Manufacturer ID", RCDManufacturerID);
+    SMBIOS_DECODE_FIELD_UINT(67, 17, "RCD Revision Number", RCDRevisionNumber);
+    SMBIOS_COMPILED_VISIT_END();
+}
+
+static const SMBIOS_COMPILED_VISIT_ROUTINE SmbiosCompiledVisitByType[256] = {
+    SmbiosCompiledVisitType0, // 0
+    NULL, // 1
+    NULL, // 2
+    NULL, // 3
+    SmbiosCompiledVisitType4, // 4
+    NULL, // 5
+    NULL, // 6
+    SmbiosCompiledVisitType7, // 7
+    NULL, // 8
+    NULL, // 9
+    NULL, // 10
+    NULL, // 11
+    NULL, // 12
+    NULL, // 13
+    NULL, // 14
+    NULL, // 15
+    NULL, // 16
+    SmbiosCompiledVisitType17, // 17
+    NULL, // 18
+    NULL, // 19
+    NULL, // 20
+    NULL, // 21
+    NULL, // 22
+    NULL, // 23
+    NULL, // 24
+    NULL, // 25
+    NULL, // 26
+    NULL, // 27
+    NULL, // 28
+    NULL, // 29
+    NULL, // 30
+    NULL, // 31
+    NULL, // 32
+    NULL, // 33
+    NULL, // 34
+    NULL, // 35
+    NULL, // 36
+    NULL, // 37
+    NULL, // 38
+    NULL, // 39
+    NULL, // 40
+    NULL, // 41
+    NULL, // 42
+    NULL, // 43
+    NULL, // 44
+    NULL, // 45
+    NULL, // 46
+    NULL, // 47
+    NULL, // 48
+    NULL, // 49
+    NULL, // 50
+    NULL, // 51
+    NULL, // 52
+    NULL, // 53
+    NULL, // 54
+    NULL, // 55
+    NULL, // 56
+    NULL, // 57
+    NULL, // 58
+    NULL, // 59
+    NULL, // 60
+    NULL, // 61
+    NULL, // 62
+    NULL, // 63
+    NULL, // 64
+    NULL, // 65
+    NULL, // 66
+    NULL, // 67
+    NULL, // 68
+    NULL, // 69
+    NULL, // 70
+    NULL, // 71
+    NULL, // 72
+    NULL, // 73
+    NULL, // 74
+    NULL, // 75
+    NULL, // 76
+    NULL, // 77
+    NULL, // 78
+    NULL, // 79
+    NULL, // 80
+    NULL, // 81
+    NULL, // 82
+    NULL, // 83
+    NULL, // 84
+    NULL, // 85
+    NULL, // 86
+    NULL, // 87
+    NULL, // 88
+    NULL, // 89
+    NULL, // 90
+    NULL, // 91
+    NULL, // 92
+    NULL, // 93
+    NULL, // 94
+    NULL, // 95
+    NULL, // 96
+    NULL, // 97
+    NULL, // 98
+    NULL, // 99
+    NULL, // 100
+    NULL, // 101
+    NULL, // 102
+    NULL, // 103
+    NULL, // 104
+    NULL, // 105
+    NULL, // 106
+    NULL, // 107
+    NULL, // 108
+    NULL, // 109
+    NULL, // 110
+    NULL, // 111
+    NULL, // 112
+    NULL, // 113
+    NULL, // 114
+    NULL, // 115
+    NULL, // 116
+    NULL, // 117
+    NULL, // 118
+    NULL, // 119
+    NULL, // 120
+    NULL, // 121
+    NULL, // 122
+    NULL, // 123
+    NULL, // 124
+    NULL, // 125
+    NULL, // 126
+    NULL, // 127
+    NULL, // 128
+    NULL, // 129
+    NULL, // 130
+    NULL, // 131
+    NULL, // 132
+    NULL, // 133
+    NULL, // 134
+    NULL, // 135
+    NULL, // 136
+    NULL, // 137
+    NULL, // 138
+    NULL, // 139
+    NULL, // 140
+    NULL, // 141
+    NULL, // 142
+    NULL, // 143
+    NULL, // 144
+    NULL, // 145
+    NULL, // 146
+    NULL, // 147
+    NULL, // 148
+    NULL, // 149
+    NULL, // 150
+    NULL, // 151
+    NULL, // 152
+    NULL, // 153
+    NULL, // 154
+    NULL, // 155
+    NULL, // 156
+    NULL, // 157
+    NULL, // 158
+    NULL, // 159
+    NULL, // 160
+    NULL, // 161
+    NULL, // 162
+    NULL, // 163
+    NULL, // 164
+    NULL, // 165
+    NULL, // 166
+    NULL, // 167
+    NULL, // 168
+    NULL, // 169
+    NULL, // 170
+    NULL, // 171
+    NULL, // 172
+    NULL, // 173
+    NULL, // 174
+    NULL, // 175
+    NULL, // 176
+    NULL, // 177
+    NULL, // 178
+    NULL, // 179
+    NULL, // 180
+    NULL, // 181
+    NULL, // 182
+    NULL, // 183
+    NULL, // 184
+    NULL, // 185
+    NULL, // 186
+    NULL, // 187
+    NULL, // 188
+    NULL, // 189
+    NULL, // 190
+    NULL, // 191
+    NULL, // 192
+    NULL, // 193
+    NULL, // 194
+    NULL, // 195
+    NULL, // 196
+    NULL, // 197
+    NULL, // 198
+    NULL, // 199
+    NULL, // 200
+    NULL, // 201
+    NULL, // 202
+    NULL, // 203
+    NULL, // 204
+    NULL, // 205
+    NULL, // 206
+    NULL, // 207
+    NULL, // 208
+    NULL, // 209
+    NULL, // 210
+    NULL, // 211
+    NULL, // 212
+    NULL, // 213
+    NULL, // 214
+    NULL, // 215
+    NULL, // 216
+    NULL, // 217
+    NULL, // 218
+    NULL, // 219
+    NULL, // 220
+    NULL, // 221
+    NULL, // 222
+    NULL, // 223
+    NULL, // 224
+    NULL, // 225
+    NULL, // 226
+    NULL, // 227
+    NULL, // 228
+    NULL, // 229
+    NULL, // 230
+    NULL, // 231
+    NULL, // 232
+    NULL, // 233
+    NULL, // 234
+    NULL, // 235
+    NULL, // 236
+    NULL, // 237
+    NULL, // 238
+    NULL, // 239
+    NULL, // 240
+    NULL, // 241
+    NULL, // 242
+    NULL, // 243
+    NULL, // 244
+    NULL, // 245
+    NULL, // 246
+    NULL, // 247
+    NULL, // 248
+    NULL, // 249
+    NULL, // 250
+    NULL, // 251
+    NULL, // 252
+    NULL, // 253
+    NULL, // 254
+    NULL, // 255
+};
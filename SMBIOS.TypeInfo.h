@@ -1991,3 +1991,263 @@ SMBIOS_TYPE_INFO SmbiosTypeInfo[] = {
     { 126, "Inactive", 0 },
     { 127, "End-of-Table", 0 },
 };
+
+SMBIOS_TYPEINFO_SELECTANY
+PSMBIOS_TYPE_INFO SmbiosTypeInfoByType[256] = {
+    &SmbiosTypeInfo[0], // 0
+    &SmbiosTypeInfo[1], // 1
+    &SmbiosTypeInfo[2], // 2
+    &SmbiosTypeInfo[3], // 3
+    &SmbiosTypeInfo[4], // 4
+    &SmbiosTypeInfo[5], // 5
+    &SmbiosTypeInfo[6], // 6
+    &SmbiosTypeInfo[7], // 7
+    &SmbiosTypeInfo[8], // 8
+    &SmbiosTypeInfo[9], // 9
+    &SmbiosTypeInfo[10], // 10
+    &SmbiosTypeInfo[11], // 11
+    &SmbiosTypeInfo[12], // 12
+    &SmbiosTypeInfo[13], // 13
+    &SmbiosTypeInfo[14], // 14
+    &SmbiosTypeInfo[15], // 15
+    &SmbiosTypeInfo[16], // 16
+    &SmbiosTypeInfo[17], // 17
+    &SmbiosTypeInfo[18], // 18
+    &SmbiosTypeInfo[19], // 19
+    &SmbiosTypeInfo[20], // 20
+    &SmbiosTypeInfo[21], // 21
+    &SmbiosTypeInfo[22], // 22
+    &SmbiosTypeInfo[23], // 23
+    &SmbiosTypeInfo[24], // 24
+    &SmbiosTypeInfo[25], // 25
+    &SmbiosTypeInfo[26], // 26
+    &SmbiosTypeInfo[27], // 27
+    &SmbiosTypeInfo[28], // 28
+    &SmbiosTypeInfo[29], // 29
+    &SmbiosTypeInfo[30], // 30
+    &SmbiosTypeInfo[31], // 31
+    &SmbiosTypeInfo[32], // 32
+    &SmbiosTypeInfo[33], // 33
+    &SmbiosTypeInfo[34], // 34
+    &SmbiosTypeInfo[35], // 35
+    &SmbiosTypeInfo[36], // 36
+    &SmbiosTypeInfo[37], // 37
+    &SmbiosTypeInfo[38], // 38
+    &SmbiosTypeInfo[39], // 39
+    &SmbiosTypeInfo[40], // 40
+    &SmbiosTypeInfo[41], // 41
+    &SmbiosTypeInfo[42], // 42
+    &SmbiosTypeInfo[43], // 43
+    &SmbiosTypeInfo[44], // 44
+    &SmbiosTypeInfo[45], // 45
+    &SmbiosTypeInfo[46], // 46
+    NULL, // 47
+    NULL, // 48
+    NULL, // 49
+    NULL, // 50
+    NULL, // 51
+    NULL, // 52
+    NULL, // 53
+    NULL, // 54
+    NULL, // 55
+    NULL, // 56
+    NULL, // 57
+    NULL, // 58
+    NULL, // 59
+    NULL, // 60
+    NULL, // 61
+    NULL, // 62
+    NULL, // 63
+    NULL, // 64
+    NULL, // 65
+    NULL, // 66
+    NULL, // 67
+    NULL, // 68
+    NULL, // 69
+    NULL, // 70
+    NULL, // 71
+    NULL, // 72
+    NULL, // 73
+    NULL, // 74
+    NULL, // 75
+    NULL, // 76
+    NULL, // 77
+    NULL, // 78
+    NULL, // 79
+    NULL, // 80
+    NULL, // 81
+    NULL, // 82
+    NULL, // 83
+    NULL, // 84
+    NULL, // 85
+    NULL, // 86
+    NULL, // 87
+    NULL, // 88
+    NULL, // 89
+    NULL, // 90
+    NULL, // 91
+    NULL, // 92
+    NULL, // 93
+    NULL, // 94
+    NULL, // 95
+    NULL, // 96
+    NULL, // 97
+    NULL, // 98
+    NULL, // 99
+    NULL, // 100
+    NULL, // 101
+    NULL, // 102
+    NULL, // 103
+    NULL, // 104
+    NULL, // 105
+    NULL, // 106
+    NULL, // 107
+    NULL, // 108
+    NULL, // 109
+    NULL, // 110
+    NULL, // 111
+    NULL, // 112
+    NULL, // 113
+    NULL, // 114
+    NULL, // 115
+    NULL, // 116
+    NULL, // 117
+    NULL, // 118
+    NULL, // 119
+    NULL, // 120
+    NULL, // 121
+    NULL, // 122
+    NULL, // 123
+    NULL, // 124
+    NULL, // 125
+    &SmbiosTypeInfo[47], // 126
+    &SmbiosTypeInfo[48], // 127
+    NULL, // 128
+    NULL, // 129
+    NULL, // 130
+    NULL, // 131
+    NULL, // 132
+    NULL, // 133
+    NULL, // 134
+    NULL, // 135
+    NULL, // 136
+    NULL, // 137
+    NULL, // 138
+    NULL, // 139
+    NULL, // 140
+    NULL, // 141
+    NULL, // 142
+    NULL, // 143
+    NULL, // 144
+    NULL, // 145
+    NULL, // 146
+    NULL, // 147
+    NULL, // 148
+    NULL, // 149
+    NULL, // 150
+    NULL, // 151
+    NULL, // 152
+    NULL, // 153
+    NULL, // 154
+    NULL, // 155
+    NULL, // 156
+    NULL, // 157
+    NULL, // 158
+    NULL, // 159
+    NULL, // 160
+    NULL, // 161
+    NULL, // 162
+    NULL, // 163
+    NULL, // 164
+    NULL, // 165
+    NULL, // 166
+    NULL, // 167
+    NULL, // 168
+    NULL, // 169
+    NULL, // 170
+    NULL, // 171
+    NULL, // 172
+    NULL, // 173
+    NULL, // 174
+    NULL, // 175
+    NULL, // 176
+    NULL, // 177
+    NULL, // 178
+    NULL, // 179
+    NULL, // 180
+    NULL, // 181
+    NULL, // 182
+    NULL, // 183
+    NULL, // 184
+    NULL, // 185
+    NULL, // 186
+    NULL, // 187
+    NULL, // 188
+    NULL, // 189
+    NULL, // 190
+    NULL, // 191
+    NULL, // 192
+    NULL, // 193
+    NULL, // 194
+    NULL, // 195
+    NULL, // 196
+    NULL, // 197
+    NULL, // 198
+    NULL, // 199
+    NULL, // 200
+    NULL, // 201
+    NULL, // 202
+    NULL, // 203
+    NULL, // 204
+    NULL, // 205
+    NULL, // 206
+    NULL, // 207
+    NULL, // 208
+    NULL, // 209
+    NULL, // 210
+    NULL, // 211
+    NULL, // 212
+    NULL, // 213
+    NULL, // 214
+    NULL, // 215
+    NULL, // 216
+    NULL, // 217
+    NULL, // 218
+    NULL, // 219
+    NULL, // 220
+    NULL, // 221
+    NULL, // 222
+    NULL, // 223
+    NULL, // 224
+    NULL, // 225
+    NULL, // 226
+    NULL, // 227
+    NULL, // 228
+    NULL, // 229
+    NULL, // 230
+    NULL, // 231
+    NULL, // 232
+    NULL, // 233
+    NULL, // 234
+    NULL, // 235
+    NULL, // 236
+    NULL, // 237
+    NULL, // 238
+    NULL, // 239
+    NULL, // 240
+    NULL, // 241
+    NULL, // 242
+    NULL, // 243
+    NULL, // 244
+    NULL, // 245
+    NULL, // 246
+    NULL, // 247
+    NULL, // 248
+    NULL, // 249
+    NULL, // 250
+    NULL, // 251
+    NULL, // 252
+    NULL, // 253
+    NULL, // 254
+    NULL, // 255
+};
@@ -25,8 +25,13 @@ static_assert(SMBIOS_VERSION >= 0x02000000);
 typedef unsigned char       UCHAR; // STRING
 typedef unsigned char       BYTE;  // UINT8
 typedef unsigned short      WORD;  // UINT16
+#if defined(_WIN32)
 typedef unsigned long       DWORD; // UINT32
+#else
+typedef unsigned int        DWORD; // UINT32, long is 64-bit on LP64
+#endif
 typedef unsigned long long  QWORD; // UINT64
+static_assert(sizeof(DWORD) == 4 && sizeof(QWORD) == 8);
 
 /* For code analysis */
 #ifdef _MSC_VER
@@ -0,0 +1,503 @@
+﻿#include "SmbiosBatch.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_WIN32)
+
+#include <Windows.h>
+
+#define PATH_SEPARATOR '\\'
+
+typedef SRWLOCK BATCH_LOCK;
+typedef CONDITION_VARIABLE BATCH_CONDITION;
+typedef HANDLE BATCH_THREAD;
+
+#define BATCH_THREAD_ROUTINE(Name) DWORD WINAPI Name(LPVOID Parameter)
+#define BATCH_THREAD_RETURN 0
+
+#define InitializeBatchLock(Lock, Condition) (InitializeSRWLock(Lock), InitializeConditionVariable(Condition))
+#define DeleteBatchLock(Lock, Condition)
+#define AcquireBatchLock(Lock) AcquireSRWLockExclusive(Lock)
+#define ReleaseBatchLock(Lock) ReleaseSRWLockExclusive(Lock)
+#define WaitBatchCondition(Condition, Lock) SleepConditionVariableSRW(Condition, Lock, INFINITE, 0)
+#define WakeBatchCondition(Condition) WakeAllConditionVariable(Condition)
+
+#elif defined(__linux__)
+
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PATH_SEPARATOR '/'
+
+typedef pthread_mutex_t BATCH_LOCK;
+typedef pthread_cond_t BATCH_CONDITION;
+typedef pthread_t BATCH_THREAD;
+
+#define BATCH_THREAD_ROUTINE(Name) void* Name(void* Parameter)
+#define BATCH_THREAD_RETURN NULL
+
+#define InitializeBatchLock(Lock, Condition) (pthread_mutex_init(Lock, NULL), pthread_cond_init(Condition, NULL))
+#define DeleteBatchLock(Lock, Condition) (pthread_cond_destroy(Condition), pthread_mutex_destroy(Lock))
+#define AcquireBatchLock(Lock) pthread_mutex_lock(Lock)
+#define ReleaseBatchLock(Lock) pthread_mutex_unlock(Lock)
+#define WaitBatchCondition(Condition, Lock) pthread_cond_wait(Condition, Lock)
+#define WakeBatchCondition(Condition) pthread_cond_broadcast(Condition)
+
+#else
+
+#error No OS target specified, currently supports Windows (_WIN32) and Linux (__linux__)
+
+#endif
+
+/* Results kept in memory for ordered output, per worker */
+#define BATCH_WINDOW_PER_THREAD 4
+
+typedef struct _BATCH_ITEM
+{
+    SMBIOS_TEXT_WRITER Writer;
+    bool Done;
+    bool Result;
+} BATCH_ITEM, *PBATCH_ITEM;
+
+typedef struct _BATCH_RUN
+{
+    PSMBIOS_BATCH Batch;
+    PBATCH_ITEM Items;              // _Field_size_(Batch->Count)
+    size_t Next;                    // Next item to decode
+    size_t Emitted;                 // Items before are written and freed
+    size_t Window;                  // Items decoded ahead of emitted ones at most
+    BATCH_LOCK Lock;
+    BATCH_CONDITION Condition;
+} BATCH_RUN, *PBATCH_RUN;
+
+static
+bool
+AddPath(
+    PSMBIOS_BATCH Batch,
+    char* Path)
+{
+    char** NewPaths;
+    size_t NewCapacity;
+
+    if (Batch->Count == Batch->Capacity)
+    {
+        NewCapacity = Batch->Capacity != 0 ? Batch->Capacity * 2 : 64;
+        NewPaths = (char**)realloc(Batch->Paths, NewCapacity * sizeof(char*));
+        if (NewPaths == NULL)
+        {
+            free(Path);
+            return false;
+        }
+        Batch->Paths = NewPaths;
+        Batch->Capacity = NewCapacity;
+    }
+    Batch->Paths[Batch->Count++] = Path;
+    return true;
+}
+
+static
+char*
+JoinPath(
+    const char* Directory,
+    const char* Name,
+    const char* Extension)
+{
+    size_t DirectoryLength, NameLength, ExtensionLength;
+    char* Path;
+
+    DirectoryLength = strlen(Directory);
+    NameLength = strlen(Name);
+    ExtensionLength = Extension != NULL ? strlen(Extension) : 0;
+    Path = (char*)malloc(DirectoryLength + 1 + NameLength + ExtensionLength + 1);
+    if (Path == NULL)
+    {
+        return NULL;
+    }
+    memcpy(Path, Directory, DirectoryLength);
+    if (DirectoryLength != 0 && Directory[DirectoryLength - 1] != PATH_SEPARATOR && Directory[DirectoryLength - 1] != '/')
+    {
+        Path[DirectoryLength++] = PATH_SEPARATOR;
+    }
+    memcpy(Path + DirectoryLength, Name, NameLength);
+    if (Extension != NULL)
+    {
+        memcpy(Path + DirectoryLength + NameLength, Extension, ExtensionLength);
+    }
+    Path[DirectoryLength + NameLength + ExtensionLength] = '\0';
+    return Path;
+}
+
+static
+const char*
+GetFileName(
+    const char* Path)
+{
+    const char* Name = Path;
+
+    for (; *Path != '\0'; Path++)
+    {
+        if (*Path == '/' || *Path == PATH_SEPARATOR)
+        {
+            Name = Path + 1;
+        }
+    }
+    return Name;
+}
+
+static int ComparePath(const void* A, const void* B)
+{
+    return strcmp(*(const char* const*)A, *(const char* const*)B);
+}
+
+#if defined(_WIN32)
+
+static
+unsigned int
+GetProcessorCount(void)
+{
+    SYSTEM_INFO Info;
+
+    GetSystemInfo(&Info);
+    return Info.dwNumberOfProcessors;
+}
+
+bool
+SmbiosAddBatchPath(
+    PSMBIOS_BATCH Batch,
+    const char* Path)
+{
+    DWORD Attributes;
+    HANDLE Find;
+    WIN32_FIND_DATAA Data;
+    char* Pattern;
+    char* File;
+    size_t First;
+
+    Attributes = GetFileAttributesA(Path);
+    if (Attributes == INVALID_FILE_ATTRIBUTES || !(Attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        File = _strdup(Path);
+        return File != NULL && AddPath(Batch, File);
+    }
+
+    Pattern = JoinPath(Path, "*", NULL);
+    if (Pattern == NULL)
+    {
+        return false;
+    }
+    Find = FindFirstFileA(Pattern, &Data);
+    free(Pattern);
+    if (Find == INVALID_HANDLE_VALUE)
+    {
+        printf("FindFirstFile failed with: 0x%08lX\n", GetLastError());
+        return false;
+    }
+    First = Batch->Count;
+    do
+    {
+        if (Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            continue;
+        }
+        File = JoinPath(Path, Data.cFileName, NULL);
+        if (File == NULL || !AddPath(Batch, File))
+        {
+            FindClose(Find);
+            return false;
+        }
+    } while (FindNextFileA(Find, &Data));
+    FindClose(Find);
+    qsort(Batch->Paths + First, Batch->Count - First, sizeof(char*), ComparePath);
+    return true;
+}
+
+static
+bool
+StartThread(
+    BATCH_THREAD* Thread,
+    LPTHREAD_START_ROUTINE Routine,
+    void* Parameter)
+{
+    *Thread = CreateThread(NULL, 0, Routine, Parameter, 0, NULL);
+    return *Thread != NULL;
+}
+
+static
+void
+JoinThread(
+    BATCH_THREAD Thread)
+{
+    WaitForSingleObject(Thread, INFINITE);
+    CloseHandle(Thread);
+}
+
+#else
+
+static
+unsigned int
+GetProcessorCount(void)
+{
+    long Count;
+
+    Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return Count > 0 ? (unsigned int)Count : 1;
+}
+
+bool
+SmbiosAddBatchPath(
+    PSMBIOS_BATCH Batch,
+    const char* Path)
+{
+    struct stat sb;
+    DIR* Directory;
+    struct dirent* Entry;
+    char* File;
+    size_t First;
+
+    if (stat(Path, &sb) < 0 || !S_ISDIR(sb.st_mode))
+    {
+        File = strdup(Path);
+        return File != NULL && AddPath(Batch, File);
+    }
+
+    Directory = opendir(Path);
+    if (Directory == NULL)
+    {
+        printf("opendir failed with: %d\n", errno);
+        return false;
+    }
+    First = Batch->Count;
+    while ((Entry = readdir(Directory)) != NULL)
+    {
+        File = JoinPath(Path, Entry->d_name, NULL);
+        if (File == NULL)
+        {
+            closedir(Directory);
+            return false;
+        }
+        if (stat(File, &sb) < 0 || !S_ISREG(sb.st_mode))
+        {
+            free(File);
+            continue;
+        }
+        if (!AddPath(Batch, File))
+        {
+            closedir(Directory);
+            return false;
+        }
+    }
+    closedir(Directory);
+    qsort(Batch->Paths + First, Batch->Count - First, sizeof(char*), ComparePath);
+    return true;
+}
+
+static
+bool
+StartThread(
+    BATCH_THREAD* Thread,
+    void* (*Routine)(void*),
+    void* Parameter)
+{
+    return pthread_create(Thread, NULL, Routine, Parameter) == 0;
+}
+
+static
+void
+JoinThread(
+    BATCH_THREAD Thread)
+{
+    pthread_join(Thread, NULL);
+}
+
+#endif
+
+/* Decode into memory for ordered output, or straight into the output file of item */
+static
+bool
+DecodeItem(
+    PBATCH_RUN Run,
+    size_t i)
+{
+    PSMBIOS_BATCH Batch = Run->Batch;
+    PSMBIOS_TEXT_WRITER Writer = &Run->Items[i].Writer;
+    const char* Extension;
+    char* OutputPath;
+    FILE* File;
+    bool Result;
+
+    if (Batch->OutputDirectory == NULL)
+    {
+        if (!SmbiosInitializeWriter(Writer, NULL, 0))
+        {
+            return false;
+        }
+        return Batch->Routine(Batch->UserData, Batch->Paths[i], Writer) && !Writer->Failed;
+    }
+
+    Extension = Batch->OutputExtension != NULL ? Batch->OutputExtension : ".txt";
+    OutputPath = JoinPath(Batch->OutputDirectory, GetFileName(Batch->Paths[i]), Extension);
+    if (OutputPath == NULL)
+    {
+        return false;
+    }
+    File = fopen(OutputPath, "w");
+    free(OutputPath);
+    if (File == NULL)
+    {
+        printf("open failed with: %d\n", errno);
+        return false;
+    }
+    Result = false;
+    if (SmbiosInitializeWriter(Writer, File, 0))
+    {
+        Result = Batch->Routine(Batch->UserData, Batch->Paths[i], Writer);
+        Result = SmbiosUninitializeWriter(Writer) && Result;
+    }
+    return fclose(File) == 0 && Result;
+}
+
+static
+BATCH_THREAD_ROUTINE(BatchWorker)
+{
+    PBATCH_RUN Run = (PBATCH_RUN)Parameter;
+    size_t i;
+    bool Result;
+
+    AcquireBatchLock(&Run->Lock);
+    while (true)
+    {
+        while (Run->Next < Run->Batch->Count && Run->Next >= Run->Emitted + Run->Window)
+        {
+            WaitBatchCondition(&Run->Condition, &Run->Lock);
+        }
+        if (Run->Next >= Run->Batch->Count)
+        {
+            break;
+        }
+        i = Run->Next++;
+        ReleaseBatchLock(&Run->Lock);
+
+        Result = DecodeItem(Run, i);
+
+        AcquireBatchLock(&Run->Lock);
+        Run->Items[i].Result = Result;
+        Run->Items[i].Done = true;
+        WakeBatchCondition(&Run->Condition);
+    }
+    ReleaseBatchLock(&Run->Lock);
+    return BATCH_THREAD_RETURN;
+}
+
+bool
+SmbiosRunBatch(
+    PSMBIOS_BATCH Batch)
+{
+    BATCH_RUN Run;
+    BATCH_THREAD* Threads;
+    unsigned int ThreadCount, Started;
+    size_t i;
+    bool Result;
+
+    if (Batch->Count == 0)
+    {
+        return true;
+    }
+    memset(&Run, 0, sizeof(Run));
+    Run.Batch = Batch;
+    Run.Items = (PBATCH_ITEM)calloc(Batch->Count, sizeof(BATCH_ITEM));
+    if (Run.Items == NULL)
+    {
+        return false;
+    }
+    ThreadCount = Batch->Threads != 0 ? Batch->Threads : GetProcessorCount();
+    if (ThreadCount > Batch->Count)
+    {
+        ThreadCount = (unsigned int)Batch->Count;
+    }
+    Threads = (BATCH_THREAD*)malloc(ThreadCount * sizeof(BATCH_THREAD));
+    if (Threads == NULL)
+    {
+        free(Run.Items);
+        return false;
+    }
+
+    /* Files are written by workers directly, no need to hold results back */
+    Run.Window = Batch->OutputDirectory == NULL ? (size_t)ThreadCount * BATCH_WINDOW_PER_THREAD : Batch->Count;
+    InitializeBatchLock(&Run.Lock, &Run.Condition);
+    for (Started = 0; Started < ThreadCount; Started++)
+    {
+        if (!StartThread(&Threads[Started], BatchWorker, &Run))
+        {
+            break;
+        }
+    }
+    if (Started == 0)
+    {
+        Run.Window = Batch->Count;
+        BatchWorker(&Run);
+    }
+
+    /* Emit results in input order as they are done */
+    Result = true;
+    for (i = 0; i < Batch->Count; i++)
+    {
+        AcquireBatchLock(&Run.Lock);
+        while (!Run.Items[i].Done)
+        {
+            WaitBatchCondition(&Run.Condition, &Run.Lock);
+        }
+        ReleaseBatchLock(&Run.Lock);
+
+        if (!Run.Items[i].Result)
+        {
+            Result = false;
+        }
+        if (Batch->OutputDirectory == NULL)
+        {
+            fprintf(Batch->Output, "==> %s <==\n", Batch->Paths[i]);
+            if (Run.Items[i].Writer.Used != 0 &&
+                fwrite(Run.Items[i].Writer.Buffer, 1, Run.Items[i].Writer.Used, Batch->Output) != Run.Items[i].Writer.Used)
+            {
+                Result = false;
+            }
+            SmbiosUninitializeWriter(&Run.Items[i].Writer);
+        }
+
+        AcquireBatchLock(&Run.Lock);
+        Run.Emitted = i + 1;
+        WakeBatchCondition(&Run.Condition);
+        ReleaseBatchLock(&Run.Lock);
+    }
+
+    while (Started != 0)
+    {
+        JoinThread(Threads[--Started]);
+    }
+    DeleteBatchLock(&Run.Lock, &Run.Condition);
+    free(Threads);
+    free(Run.Items);
+    if (Batch->OutputDirectory == NULL && fflush(Batch->Output) != 0)
+    {
+        Result = false;
+    }
+    return Result;
+}
+
+void
+SmbiosFreeBatch(
+    PSMBIOS_BATCH Batch)
+{
+    size_t i;
+
+    for (i = 0; i < Batch->Count; i++)
+    {
+        free(Batch->Paths[i]);
+    }
+    free(Batch->Paths);
+    memset(Batch, 0, sizeof(*Batch));
+}
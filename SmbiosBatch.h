@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include "SmbiosWriter.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Worker threads a batch could be asked for, far more than inputs are usually decoded in parallel */
+#define SMBIOS_BATCH_MAX_THREADS 1024
+
+/* Decode one input into writer, returns false on failure but output written so far is kept */
+typedef
+bool
+(*SMBIOS_BATCH_ROUTINE)(
+    void* UserData,
+    const char* Path,
+    PSMBIOS_TEXT_WRITER Writer);
+
+/*
+ * Decode many inputs on a worker pool, Routine and UserData must be safe to be used by several threads.
+ *
+ * With Output, results are written in input order, each after a "==> Path <==" line.
+ * With OutputDirectory, each result is written to "<OutputDirectory>/<file name of input><OutputExtension>" instead.
+ */
+typedef struct _SMBIOS_BATCH
+{
+    char** Paths;                   // _Field_size_(Count), input order
+    size_t Count;
+    size_t Capacity;
+    unsigned int Threads;           // 0 for number of processors, at most SMBIOS_BATCH_MAX_THREADS
+    FILE* Output;
+    const char* OutputDirectory;
+    const char* OutputExtension;    // NULL for ".txt"
+    SMBIOS_BATCH_ROUTINE Routine;
+    void* UserData;
+} SMBIOS_BATCH, *PSMBIOS_BATCH;
+
+/* Add a file, or regular files directly in a directory sorted by name */
+bool
+SmbiosAddBatchPath(
+    PSMBIOS_BATCH Batch,
+    const char* Path);
+
+/* Returns false if any input failed */
+bool
+SmbiosRunBatch(
+    PSMBIOS_BATCH Batch);
+
+void
+SmbiosFreeBatch(
+    PSMBIOS_BATCH Batch);
@@ -0,0 +1,1289 @@
+﻿#include "CPUID.h"
+#include "SMBIOS.h"
+#include "SMBIOS.TypeInfo.h"
+#include "SmbiosBatch.h"
+#include "SmbiosContext.h"
+#include "SmbiosCorpus.h"
+#include "SmbiosFingerprint.h"
+#include "SmbiosJson.h"
+#include "SmbiosLoader.h"
+#include "SmbiosStats.h"
+#include "SmbiosText.h"
+#include "SmbiosVisit.h"
+#include "SmbiosWriter.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_WIN32) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BENCH_CYCLES
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#define BENCH_DEFAULT_TIME_MS 500
+#define BENCH_DEFAULT_SAMPLES 100000
+#define BENCH_CALIBRATE_TIME_MS 100
+#define BENCH_OVERHEAD_ROUNDS 10000
+#define BENCH_OUTPUT_BUFFER_SIZE 0x100000
+#define BENCH_STAGE_COUNT (sizeof(Stages) / sizeof(Stages[0]))
+#define BENCH_PROBE_COUNT (sizeof(Probes) / sizeof(Probes[0]))
+
+/* Synthetic part of the corpus, fixed so results of different builds are comparable */
+static const char* const SyntheticTables[] = {
+    "default",
+    "all-types",
+    "all-types,truncate,version=2.4,seed=2",
+    "4=4,7=24,9=16,17=256,19=4,strings=4,strlen=48,seed=3",
+    "17=4096,seed=4",
+};
+
+#pragma region Allocation Counting
+
+/*
+ * Allocations are counted only in builds that can hook them:
+ *   Linux: -DSMBIOS_BENCH_WRAP_MALLOC -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+ *   Windows: Debug configuration, by CRT allocation hook
+ */
+static size_t AllocationCount;
+
+#if defined(SMBIOS_BENCH_WRAP_MALLOC)
+
+#define BENCH_COUNT_ALLOCATIONS
+
+void* __real_malloc(size_t Size);
+void* __real_calloc(size_t Count, size_t Size);
+void* __real_realloc(void* Pointer, size_t Size);
+
+void*
+__wrap_malloc(
+    size_t Size)
+{
+    AllocationCount++;
+    return __real_malloc(Size);
+}
+
+void*
+__wrap_calloc(
+    size_t Count,
+    size_t Size)
+{
+    AllocationCount++;
+    return __real_calloc(Count, Size);
+}
+
+void*
+__wrap_realloc(
+    void* Pointer,
+    size_t Size)
+{
+    AllocationCount++;
+    return __real_realloc(Pointer, Size);
+}
+
+#elif defined(_WIN32) && defined(_DEBUG)
+
+#define BENCH_COUNT_ALLOCATIONS
+
+static
+int
+__cdecl
+CountAllocation(
+    int AllocType,
+    void* UserData,
+    size_t Size,
+    int BlockType,
+    long RequestNumber,
+    const unsigned char* FileName,
+    int LineNumber)
+{
+    if (AllocType == _HOOK_ALLOC || AllocType == _HOOK_REALLOC)
+    {
+        AllocationCount++;
+    }
+    return TRUE;
+}
+
+#endif
+
+#pragma endregion
+
+#pragma region Cycle Counter
+
+/*
+ * Cost of a single call in TSC cycles, too short for the wall clock. The call is fenced by CPUID before RDTSC,
+ * and RDTSCP followed by CPUID after, so it can neither start before the first read nor finish after the second.
+ * Cost of the fences themselves is measured beforehand and taken out of results. CPUID traps to the hypervisor in
+ * virtual machines, which makes the fences slow and results noisy there.
+ */
+typedef struct _CYCLE_COUNTER
+{
+    QWORD Frequency;                // TSC ticks per second
+    const char* Source;             // Where Frequency came from
+    QWORD Overhead;                 // Cycles of an empty measurement
+    bool Invariant;                 // TSC runs at constant rate in all power states
+    bool Rdtscp;
+} CYCLE_COUNTER, *PCYCLE_COUNTER;
+
+typedef struct _CYCLE_SAMPLES
+{
+    QWORD* Cycles;                  // _Field_size_(Capacity)
+    size_t Count;
+    size_t Capacity;
+} CYCLE_SAMPLES, *PCYCLE_SAMPLES;
+
+#if defined(BENCH_CYCLES)
+
+static bool UseRdtscp;
+
+static
+void
+ReadCpuid(
+    PCPUID_INFO Info,
+    unsigned int Leaf,
+    unsigned int SubLeaf)
+{
+#if defined(_MSC_VER)
+    __cpuidex(Info->Registers, (int)Leaf, (int)SubLeaf);
+#else
+    __cpuid_count(Leaf, SubLeaf, Info->Eax, Info->Ebx, Info->Ecx, Info->Edx);
+#endif
+}
+
+static
+QWORD
+ReadCycleStart(void)
+{
+#if defined(_MSC_VER)
+    int Registers[4];
+
+    __cpuid(Registers, 0);
+    return __rdtsc();
+#else
+    unsigned int Low, High, SubLeaf = 0;
+
+    /* CPUID writes ECX, so the sub-leaf is read-write */
+    __asm__ __volatile__("cpuid\n\t"
+                         "rdtsc"
+                         : "=a"(Low), "=d"(High), "+c"(SubLeaf)
+                         : "a"(0)
+                         : "ebx", "memory");
+    return ((QWORD)High << 32) | Low;
+#endif
+}
+
+/* Without RDTSCP, the CPUID before RDTSC waits for the call instead */
+static
+QWORD
+ReadCycleEnd(void)
+{
+#if defined(_MSC_VER)
+    int Registers[4];
+    unsigned int Aux;
+    QWORD Cycles;
+
+    if (!UseRdtscp)
+    {
+        return ReadCycleStart();
+    }
+    Cycles = __rdtscp(&Aux);
+    __cpuid(Registers, 0);
+    return Cycles;
+#else
+    unsigned int Low, High;
+
+    if (!UseRdtscp)
+    {
+        return ReadCycleStart();
+    }
+    __asm__ __volatile__("rdtscp\n\t"
+                         "mov %%eax, %0\n\t"
+                         "mov %%edx, %1\n\t"
+                         "xor %%eax, %%eax\n\t"
+                         "cpuid"
+                         : "=r"(Low), "=r"(High)
+                         :
+                         : "eax", "ebx", "ecx", "edx", "memory");
+    return ((QWORD)High << 32) | Low;
+#endif
+}
+
+/*
+ * TSC frequency is crystal clock times the ratio of CPUID 15H, or the base frequency of 16H on processors not
+ * enumerating the crystal clock (TSC runs at base frequency there), or measured against the wall clock otherwise.
+ */
+static
+void
+GetCycleFrequency(
+    PCYCLE_COUNTER Counter)
+{
+    CPUID_INFO Info;
+    unsigned int MaxLeaf;
+    QWORD StartNs, StartCycles, Elapsed;
+
+    ReadCpuid(&Info, 0, 0);
+    MaxLeaf = Info.F00_00.MaxInputValue;
+    if (MaxLeaf >= 0x15)
+    {
+        ReadCpuid(&Info, 0x15, 0);
+        if (Info.F15_00.Denominator != 0 && Info.F15_00.Numerator != 0 && Info.F15_00.CrystalClockFrequency != 0)
+        {
+            Counter->Frequency = (QWORD)Info.F15_00.CrystalClockFrequency * Info.F15_00.Numerator / Info.F15_00.Denominator;
+            Counter->Source = "CPUID 15H";
+            return;
+        }
+    }
+    if (MaxLeaf >= 0x16)
+    {
+        ReadCpuid(&Info, 0x16, 0);
+        if (Info.F16_00.BaseFrequency != 0)
+        {
+            Counter->Frequency = (QWORD)Info.F16_00.BaseFrequency * 1000000;
+            Counter->Source = "CPUID 16H base frequency";
+            return;
+        }
+    }
+
+    StartNs = SmbiosGetNanoseconds();
+    StartCycles = ReadCycleStart();
+    do
+    {
+        Elapsed = SmbiosGetNanoseconds() - StartNs;
+    } while (Elapsed < BENCH_CALIBRATE_TIME_MS * 1000000ULL);
+    Counter->Frequency = (ReadCycleEnd() - StartCycles) * 1000000000ULL / Elapsed;
+    Counter->Source = "measured against wall clock";
+}
+
+static
+bool
+InitializeCycleCounter(
+    PCYCLE_COUNTER Counter)
+{
+    CPUID_INFO Info;
+    QWORD Start, Cycles;
+    unsigned int i;
+
+    memset(Counter, 0, sizeof(*Counter));
+    ReadCpuid(&Info, 0x80000000, 0);
+    if (Info.F80000000_00.MaxInputValue >= 0x80000001)
+    {
+        ReadCpuid(&Info, 0x80000001, 0);
+        Counter->Rdtscp = Info.F80000001_00.RDTSCP;
+    }
+    ReadCpuid(&Info, 0x80000000, 0);
+    if (Info.F80000000_00.MaxInputValue >= 0x80000007)
+    {
+        ReadCpuid(&Info, 0x80000007, 0);
+        Counter->Invariant = Info.F80000007_00.InvariantTSC;
+    }
+    UseRdtscp = Counter->Rdtscp;
+
+    GetCycleFrequency(Counter);
+    if (Counter->Frequency == 0)
+    {
+        return false;
+    }
+    Counter->Overhead = ~(QWORD)0;
+    for (i = 0; i < BENCH_OVERHEAD_ROUNDS; i++)
+    {
+        Start = ReadCycleStart();
+        Cycles = ReadCycleEnd() - Start;
+        if (Cycles < Counter->Overhead)
+        {
+            Counter->Overhead = Cycles;
+        }
+    }
+    return true;
+}
+
+#else
+
+/* No cycle counter, probes still build but are never run */
+static
+QWORD
+ReadCycleStart(void)
+{
+    return 0;
+}
+
+static
+QWORD
+ReadCycleEnd(void)
+{
+    return 0;
+}
+
+#endif
+
+/* Samples beyond capacity are dropped */
+static
+void
+AddSample(
+    PCYCLE_SAMPLES Samples,
+    QWORD Cycles)
+{
+    if (Samples->Count < Samples->Capacity)
+    {
+        Samples->Cycles[Samples->Count++] = Cycles;
+    }
+}
+
+static
+int
+CompareSamples(
+    const void* A,
+    const void* B)
+{
+    QWORD a = *(const QWORD*)A, b = *(const QWORD*)B;
+
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+#pragma endregion
+
+typedef struct _BENCH_TABLE
+{
+    char* Name;
+    SMBIOS_TABLE_VIEW View;
+    DWORD StructureCount;
+    SMBIOS_TABLE_INDEX Index;       // Structures found beforehand, for stages not walking the table
+} BENCH_TABLE, *PBENCH_TABLE;
+
+typedef struct _BENCH_STATE
+{
+    PBENCH_TABLE Tables;            // _Field_size_(TableCount)
+    size_t TableCount;
+    QWORD StructureCount;           // Of all tables
+    QWORD Length;                   // Of all tables
+    SMBIOS_DECODE_PLANS Plans;
+    SMBIOS_DECODE_PLANS InterpretPlans; // Same plans without generated visit functions
+    SMBIOS_DECODE_PLANS NoEnumPlans;    // Interpreted without enumeration lookup
+    SMBIOS_TEXT_WRITER Writer;      // In memory, emptied for each table
+    QWORD Sink;                     // Results are summed up here so no stage could be optimized away
+} BENCH_STATE, *PBENCH_STATE;
+
+typedef
+bool
+(*BENCH_ROUTINE)(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table);
+
+typedef struct _BENCH_STAGE
+{
+    const char* Name;
+    const char* Description;
+    BENCH_ROUTINE Routine;
+    int Base;                       // Index of the stage this one is built on, -1 for none
+} BENCH_STAGE, *PBENCH_STAGE;
+
+/* Add cycles of each call on the hot path for every structure in table to samples */
+typedef
+bool
+(*BENCH_PROBE_ROUTINE)(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples);
+
+typedef struct _BENCH_PROBE
+{
+    const char* Name;
+    const char* Description;
+    BENCH_PROBE_ROUTINE Routine;
+} BENCH_PROBE, *PBENCH_PROBE;
+
+#pragma region Stages
+
+/* Boundaries only, string-set is walked but strings are not recorded */
+static
+bool
+BenchWalk(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    PSMBIOS_TABLE Structure;
+    const void* EndOfData;
+    BYTE StringCount;
+
+    EndOfData = AddPtr(Table->View.SMBIOSTableData, Table->View.Length);
+    for (Structure = (PSMBIOS_TABLE)Table->View.SMBIOSTableData;
+         Structure != NULL && SubPtr(Structure, EndOfData) >= sizeof(SMBIOS_HEADER);
+         Structure = SmbiosWalkStructure(Structure, EndOfData, NULL, &StringCount))
+    {
+        State->Sink += Structure->Header.Type;
+    }
+    return true;
+}
+
+static
+bool
+BenchStrings(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    PSMBIOS_TABLE Structure;
+    const void* EndOfData;
+    const char* Strings[SMBIOS_MAX_STRINGS];
+    BYTE StringCount = 0;
+
+    EndOfData = AddPtr(Table->View.SMBIOSTableData, Table->View.Length);
+    for (Structure = (PSMBIOS_TABLE)Table->View.SMBIOSTableData;
+         Structure != NULL && SubPtr(Structure, EndOfData) >= sizeof(SMBIOS_HEADER);
+         Structure = SmbiosWalkStructure(Structure, EndOfData, Strings, &StringCount))
+    {
+        State->Sink += StringCount;
+    }
+    return true;
+}
+
+/* Decode context walk, NUL bitmap scan with string-set indexing */
+static
+bool
+BenchScan(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+
+    if (!SmbiosInitializeContext(&Context, Table->View.SMBIOSTableData, Table->View.Length, NULL))
+    {
+        return false;
+    }
+    while (SmbiosNextStructure(&Context))
+    {
+        State->Sink += Context.StringCount;
+    }
+    SmbiosUninitializeContext(&Context);
+    return true;
+}
+
+/* Type information and decode plan of each structure, over the prebuilt index */
+static
+bool
+BenchLookup(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    PSMBIOS_TYPE_INFO TypeInfo;
+    const SMBIOS_INDEX_ENTRY* Entry;
+    DWORD i;
+
+    for (i = 0; i < Table->Index.Count; i++)
+    {
+        Entry = &Table->Index.Entries[i];
+        TypeInfo = SmbiosTypeInfoByType[Entry->Type];
+        if (TypeInfo != NULL)
+        {
+            State->Sink += TypeInfo->FieldCount + SmbiosDecodePlanStepCount(&State->Plans.ByType[Entry->Type], Entry->Length);
+        }
+    }
+    return true;
+}
+
+static
+SMBIOS_VISIT_ACTION
+SumField(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    *(QWORD*)UserData += Value->Value + (Value->Enum != NULL) + (Value->String != NULL);
+    return SmbiosVisitContinue;
+}
+
+static
+bool
+VisitTable(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    const SMBIOS_DECODE_PLANS* Plans,
+    const SMBIOS_VISITOR* Visitor)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+
+    if (!SmbiosInitializeContext(&Context, Table->View.SMBIOSTableData, Table->View.Length, Plans))
+    {
+        return false;
+    }
+    SmbiosVisitTable(&Context, Visitor);
+    SmbiosUninitializeContext(&Context);
+    return true;
+}
+
+static
+bool
+BenchFields(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_VISITOR Visitor = { &State->Sink, NULL, SumField, SumField, SumField, NULL };
+
+    return VisitTable(State, Table, &State->NoEnumPlans, &Visitor);
+}
+
+static
+bool
+BenchEnums(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_VISITOR Visitor = { &State->Sink, NULL, SumField, SumField, SumField, NULL };
+
+    return VisitTable(State, Table, &State->InterpretPlans, &Visitor);
+}
+
+/* Decoding as SmbiosDecode does, with generated visit functions */
+static
+bool
+BenchVisit(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_VISITOR Visitor = { &State->Sink, NULL, SumField, SumField, SumField, NULL };
+
+    return VisitTable(State, Table, &State->Plans, &Visitor);
+}
+
+static
+bool
+BenchText(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_VISITOR Printer;
+
+    State->Writer.Used = 0;
+    SmbiosInitializeTextPrinter(&State->Writer, &Printer);
+    if (!VisitTable(State, Table, &State->Plans, &Printer))
+    {
+        return false;
+    }
+    State->Sink += State->Writer.Used;
+    return !State->Writer.Failed;
+}
+
+static
+bool
+BenchJson(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_JSON_PRINTER JsonPrinter;
+    SMBIOS_VISITOR Printer;
+
+    State->Writer.Used = 0;
+    SmbiosInitializeJsonPrinter(&JsonPrinter, &State->Writer, &Printer);
+    if (!VisitTable(State, Table, &State->Plans, &Printer))
+    {
+        return false;
+    }
+    State->Sink += State->Writer.Used;
+    return !State->Writer.Failed;
+}
+
+/* Whole table hash, what telling an unchanged table costs */
+static
+bool
+BenchHash(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    State->Sink += SmbiosHashTable(Table->View.SMBIOSTableData, Table->View.Length);
+    return true;
+}
+
+static
+bool
+BenchFingerprint(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table)
+{
+    SMBIOS_FINGERPRINT Fingerprint;
+
+    if (!SmbiosFingerprintTable(Table->View.SMBIOSTableData, Table->View.Length, &Fingerprint))
+    {
+        return false;
+    }
+    State->Sink += Fingerprint.StableHash;
+    SmbiosFreeFingerprint(&Fingerprint);
+    return true;
+}
+
+/* Net cost of a stage is its time less the time of its base stage */
+static const BENCH_STAGE Stages[] = {
+    { "walk", "Structure boundaries by string-set walk", BenchWalk, -1 },
+    { "strings", "Walk with string-set indexing", BenchStrings, -1 },
+    { "scan", "Decode context walk, bitmap boundaries and string-set indexing", BenchScan, -1 },
+    { "lookup", "Type information and decode plan lookup", BenchLookup, -1 },
+    { "fields", "Field extraction by interpreted plans, without enumerations", BenchFields, 2 },
+    { "enums", "Field extraction with enumeration resolution", BenchEnums, 4 },
+    { "visit", "Field extraction by generated visit functions", BenchVisit, 2 },
+    { "text", "Text output formatting", BenchText, 6 },
+    { "json", "JSON output formatting", BenchJson, 6 },
+    { "hash", "Whole table hash", BenchHash, -1 },
+    { "finger", "Fingerprint, hash of each structure by handle", BenchFingerprint, -1 },
+};
+
+#pragma endregion
+
+#pragma region Probes
+
+static
+bool
+ProbeWalk(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    PSMBIOS_TABLE Structure, Next;
+    const void* EndOfData;
+    BYTE StringCount;
+    QWORD Start;
+    DWORD i;
+
+    EndOfData = AddPtr(Table->View.SMBIOSTableData, Table->View.Length);
+    for (i = 0; i < Table->Index.Count; i++)
+    {
+        Structure = (PSMBIOS_TABLE)AddPtr(Table->View.SMBIOSTableData, Table->Index.Entries[i].Offset);
+        Start = ReadCycleStart();
+        Next = SmbiosWalkStructure(Structure, EndOfData, NULL, &StringCount);
+        AddSample(Samples, ReadCycleEnd() - Start);
+        State->Sink += (Next != NULL) + StringCount;
+    }
+    return true;
+}
+
+static
+bool
+ProbeStrings(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    PSMBIOS_TABLE Structure, Next;
+    const void* EndOfData;
+    const char* Strings[SMBIOS_MAX_STRINGS];
+    BYTE StringCount;
+    QWORD Start;
+    DWORD i;
+
+    EndOfData = AddPtr(Table->View.SMBIOSTableData, Table->View.Length);
+    for (i = 0; i < Table->Index.Count; i++)
+    {
+        Structure = (PSMBIOS_TABLE)AddPtr(Table->View.SMBIOSTableData, Table->Index.Entries[i].Offset);
+        Start = ReadCycleStart();
+        Next = SmbiosWalkStructure(Structure, EndOfData, Strings, &StringCount);
+        AddSample(Samples, ReadCycleEnd() - Start);
+        State->Sink += (Next != NULL) + StringCount;
+    }
+    return true;
+}
+
+static
+bool
+ProbeNext(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+    QWORD Start;
+    bool Next;
+
+    if (!SmbiosInitializeContext(&Context, Table->View.SMBIOSTableData, Table->View.Length, &State->Plans))
+    {
+        return false;
+    }
+    do
+    {
+        Start = ReadCycleStart();
+        Next = SmbiosNextStructure(&Context);
+        AddSample(Samples, ReadCycleEnd() - Start);
+        State->Sink += Context.StringCount;
+    } while (Next);
+    SmbiosUninitializeContext(&Context);
+    return true;
+}
+
+static
+bool
+ProbeLookup(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    PSMBIOS_TYPE_INFO TypeInfo;
+    const SMBIOS_INDEX_ENTRY* Entry;
+    QWORD Start;
+    WORD StepCount;
+    DWORD i;
+
+    for (i = 0; i < Table->Index.Count; i++)
+    {
+        Entry = &Table->Index.Entries[i];
+        Start = ReadCycleStart();
+        TypeInfo = SmbiosTypeInfoByType[Entry->Type];
+        StepCount = TypeInfo != NULL ? SmbiosDecodePlanStepCount(&State->Plans.ByType[Entry->Type], Entry->Length) : 0;
+        AddSample(Samples, ReadCycleEnd() - Start);
+        State->Sink += StepCount;
+    }
+    return true;
+}
+
+/* Each structure visited on its own, moving to it and emptying the writer are not counted */
+static
+bool
+ProbeVisits(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    const SMBIOS_VISITOR* Visitor,
+    PCYCLE_SAMPLES Samples)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+    QWORD Start;
+
+    if (!SmbiosInitializeContext(&Context, Table->View.SMBIOSTableData, Table->View.Length, &State->Plans))
+    {
+        return false;
+    }
+    while (SmbiosNextStructure(&Context))
+    {
+        State->Writer.Used = 0;
+        Start = ReadCycleStart();
+        SmbiosVisitStructure(&Context, Visitor);
+        AddSample(Samples, ReadCycleEnd() - Start);
+    }
+    SmbiosUninitializeContext(&Context);
+    State->Sink += State->Writer.Used;
+    return !State->Writer.Failed;
+}
+
+static
+bool
+ProbeVisit(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    SMBIOS_VISITOR Visitor = { &State->Sink, NULL, SumField, SumField, SumField, NULL };
+
+    return ProbeVisits(State, Table, &Visitor, Samples);
+}
+
+static
+bool
+ProbeText(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    SMBIOS_VISITOR Printer;
+
+    SmbiosInitializeTextPrinter(&State->Writer, &Printer);
+    return ProbeVisits(State, Table, &Printer, Samples);
+}
+
+static
+bool
+ProbeJson(
+    PBENCH_STATE State,
+    const BENCH_TABLE* Table,
+    PCYCLE_SAMPLES Samples)
+{
+    SMBIOS_JSON_PRINTER JsonPrinter;
+    SMBIOS_VISITOR Printer;
+
+    SmbiosInitializeJsonPrinter(&JsonPrinter, &State->Writer, &Printer);
+    return ProbeVisits(State, Table, &Printer, Samples);
+}
+
+static const BENCH_PROBE Probes[] = {
+    { "walk", "SmbiosWalkStructure, boundaries only", ProbeWalk },
+    { "strings", "SmbiosWalkStructure with string-set indexing", ProbeStrings },
+    { "next", "SmbiosNextStructure, bitmap boundaries and string-set indexing", ProbeNext },
+    { "lookup", "Type information and decode plan lookup", ProbeLookup },
+    { "visit", "SmbiosVisitStructure by generated visit functions", ProbeVisit },
+    { "text", "SmbiosVisitStructure with text output formatting", ProbeText },
+    { "json", "SmbiosVisitStructure with JSON output formatting", ProbeJson },
+};
+
+#pragma endregion
+
+#pragma region Corpus
+
+static
+PBENCH_TABLE
+AddTable(
+    PBENCH_STATE State,
+    const char* Name)
+{
+    PBENCH_TABLE Tables, Table;
+
+    Tables = (PBENCH_TABLE)realloc(State->Tables, (State->TableCount + 1) * sizeof(BENCH_TABLE));
+    if (Tables == NULL)
+    {
+        return NULL;
+    }
+    State->Tables = Tables;
+    Table = &Tables[State->TableCount];
+    memset(Table, 0, sizeof(*Table));
+    Table->Name = (char*)malloc(strlen(Name) + 1);
+    if (Table->Name == NULL)
+    {
+        return NULL;
+    }
+    memcpy(Table->Name, Name, strlen(Name) + 1);
+    State->TableCount++;
+    return Table;
+}
+
+/* Index the table just added, or drop it if it could not be indexed */
+static
+bool
+CommitTable(
+    PBENCH_STATE State,
+    PBENCH_TABLE Table)
+{
+    if (!SmbiosBuildIndex(Table->View.SMBIOSTableData, Table->View.Length, &Table->Index))
+    {
+        UnmapSmbiosTableData(&Table->View);
+        free(Table->Name);
+        State->TableCount--;
+        return false;
+    }
+    Table->StructureCount = Table->Index.Count;
+    State->StructureCount += Table->StructureCount;
+    State->Length += Table->View.Length;
+    return true;
+}
+
+static
+bool
+AddSyntheticTable(
+    PBENCH_STATE State,
+    const char* Spec)
+{
+    SMBIOS_CORPUS_OPTIONS Options;
+    PSMBIOS_RAW_DATA Data;
+    PBENCH_TABLE Table;
+
+    SmbiosInitializeCorpusOptions(&Options);
+    if (strcmp(Spec, "default") != 0 && !SmbiosParseCorpusOptions(Spec, &Options))
+    {
+        return false;
+    }
+    if (!SmbiosGenerateTable(&Options, &Data))
+    {
+        return false;
+    }
+    Table = AddTable(State, Spec);
+    if (Table == NULL)
+    {
+        free(Data);
+        return false;
+    }
+    AttachSmbiosTableData(Data, &Table->View);
+    return CommitTable(State, Table);
+}
+
+static
+bool
+AddDumpTable(
+    PBENCH_STATE State,
+    const char* Path)
+{
+    PBENCH_TABLE Table;
+
+    Table = AddTable(State, Path);
+    if (Table == NULL)
+    {
+        return false;
+    }
+    if (!MapSmbiosTableDump(Path, &Table->View))
+    {
+        free(Table->Name);
+        State->TableCount--;
+        return false;
+    }
+    return CommitTable(State, Table);
+}
+
+static
+bool
+AddLiveTable(
+    PBENCH_STATE State)
+{
+    PBENCH_TABLE Table;
+
+    Table = AddTable(State, "live");
+    if (Table == NULL)
+    {
+        return false;
+    }
+    if (!MapSmbiosTableData(&Table->View))
+    {
+        free(Table->Name);
+        State->TableCount--;
+        return false;
+    }
+    return CommitTable(State, Table);
+}
+
+static
+void
+FreeCorpus(
+    PBENCH_STATE State)
+{
+    size_t i;
+
+    for (i = 0; i < State->TableCount; i++)
+    {
+        SmbiosFreeIndex(&State->Tables[i].Index);
+        UnmapSmbiosTableData(&State->Tables[i].View);
+        free(State->Tables[i].Name);
+    }
+    free(State->Tables);
+    State->Tables = NULL;
+    State->TableCount = 0;
+}
+
+#pragma endregion
+
+/* Decode plans of each flavor, interpreted ones with enumeration lookup removed from steps */
+static
+bool
+CompileBenchPlans(
+    PBENCH_STATE State)
+{
+    WORD Step;
+    unsigned int Type;
+
+    if (!SmbiosCompileDecodePlans(&State->Plans))
+    {
+        return false;
+    }
+    if (!SmbiosCompileDecodePlans(&State->InterpretPlans))
+    {
+        SmbiosFreeDecodePlans(&State->Plans);
+        return false;
+    }
+    if (!SmbiosCompileDecodePlans(&State->NoEnumPlans))
+    {
+        SmbiosFreeDecodePlans(&State->InterpretPlans);
+        SmbiosFreeDecodePlans(&State->Plans);
+        return false;
+    }
+    State->InterpretPlans.InterpretOnly = true;
+    State->NoEnumPlans.InterpretOnly = true;
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        for (Step = 0; Step < State->NoEnumPlans.ByType[Type].StepCount; Step++)
+        {
+            State->NoEnumPlans.ByType[Type].Steps[Step].Flags &= ~SMBIOS_DECODE_STEP_ENUM;
+        }
+    }
+    return true;
+}
+
+/* Run a stage over the whole corpus until at least TimeMs passed, after a warm-up round */
+static
+bool
+RunStage(
+    PBENCH_STATE State,
+    const BENCH_STAGE* Stage,
+    QWORD TimeMs,
+    double* NsPerStructure,
+    double* Allocations)
+{
+    QWORD Start, Elapsed, Rounds;
+    size_t i, Count;
+
+    for (i = 0; i < State->TableCount; i++)
+    {
+        if (!Stage->Routine(State, &State->Tables[i]))
+        {
+            return false;
+        }
+    }
+
+    Count = AllocationCount;
+    Rounds = 0;
+    Start = SmbiosGetNanoseconds();
+    do
+    {
+        for (i = 0; i < State->TableCount; i++)
+        {
+            Stage->Routine(State, &State->Tables[i]);
+        }
+        Rounds++;
+        Elapsed = SmbiosGetNanoseconds() - Start;
+    } while (Elapsed < TimeMs * 1000000ULL);
+
+    *NsPerStructure = (double)Elapsed / (double)(Rounds * State->StructureCount);
+    *Allocations = (double)(AllocationCount - Count) / (double)(Rounds * State->TableCount);
+    return true;
+}
+
+/* Sample a probe over the whole corpus until Samples is full, after a warm-up round, sorted */
+static
+bool
+RunProbe(
+    PBENCH_STATE State,
+    const BENCH_PROBE* Probe,
+    PCYCLE_SAMPLES Samples)
+{
+    size_t i;
+
+    Samples->Count = 0;
+    for (i = 0; i < State->TableCount; i++)
+    {
+        if (!Probe->Routine(State, &State->Tables[i], Samples))
+        {
+            return false;
+        }
+    }
+
+    Samples->Count = 0;
+    while (Samples->Count < Samples->Capacity)
+    {
+        for (i = 0; i < State->TableCount; i++)
+        {
+            Probe->Routine(State, &State->Tables[i], Samples);
+        }
+    }
+    qsort(Samples->Cycles, Samples->Count, sizeof(QWORD), CompareSamples);
+    return true;
+}
+
+/* Per-call cycle distribution of each probe, fence overhead taken out */
+static
+int
+RunProbes(
+    PBENCH_STATE State,
+    size_t SampleCount)
+{
+#if defined(BENCH_CYCLES)
+    CYCLE_COUNTER Counter;
+    CYCLE_SAMPLES Samples;
+    QWORD Cycles[3];
+    double Ns[3];
+    size_t i, j;
+    int Ret = 0;
+
+    if (!InitializeCycleCounter(&Counter))
+    {
+        puts("Get TSC frequency failed");
+        return ENOTSUP;
+    }
+    Samples.Cycles = (QWORD*)malloc(SampleCount * sizeof(QWORD));
+    if (Samples.Cycles == NULL)
+    {
+        puts("Allocate samples failed");
+        return ENOMEM;
+    }
+    Samples.Capacity = SampleCount;
+
+    printf("TSC: %.3f MHz (%s), %s, %s, fence overhead %llu cycles\n",
+           (double)Counter.Frequency / 1e6,
+           Counter.Source,
+           Counter.Invariant ? "invariant" : "not invariant",
+           Counter.Rdtscp ? "RDTSCP" : "no RDTSCP",
+           (unsigned long long)Counter.Overhead);
+    printf("\n%-8s %8s %8s %8s %10s %10s %10s  %s\n", "Probe", "Min", "Median", "p99", "Min ns", "Median ns", "p99 ns", "Description");
+    for (i = 0; i < BENCH_PROBE_COUNT; i++)
+    {
+        if (!RunProbe(State, &Probes[i], &Samples))
+        {
+            printf("%-8s failed\n", Probes[i].Name);
+            Ret = EIO;
+            continue;
+        }
+        Cycles[0] = Samples.Cycles[0];
+        Cycles[1] = Samples.Cycles[Samples.Count / 2];
+        Cycles[2] = Samples.Cycles[Samples.Count * 99 / 100];
+        for (j = 0; j < 3; j++)
+        {
+            Cycles[j] = Cycles[j] > Counter.Overhead ? Cycles[j] - Counter.Overhead : 0;
+            Ns[j] = (double)Cycles[j] * 1e9 / (double)Counter.Frequency;
+        }
+        printf("%-8s %8llu %8llu %8llu %10.1f %10.1f %10.1f  %s\n",
+               Probes[i].Name,
+               (unsigned long long)Cycles[0],
+               (unsigned long long)Cycles[1],
+               (unsigned long long)Cycles[2],
+               Ns[0],
+               Ns[1],
+               Ns[2],
+               Probes[i].Description);
+    }
+    printf("\nCycles are TSC cycles per call for one structure, over %zu calls each\n", Samples.Count);
+    free(Samples.Cycles);
+    return Ret;
+#else
+    puts("Cycle counter is only supported on x86 and x64");
+    return ENOTSUP;
+#endif
+}
+
+static
+void
+PrintUsage(void)
+{
+    puts("Usage: SmbiosBench [--time MS] [--cycles [--samples N]] [--live] [PATH...]\n"
+         "  --time MS           Minimum run time of each stage, defaults to 500\n"
+         "  --cycles            Per-call TSC cycle distribution of hot paths instead of stage throughput\n"
+         "  --samples N         Calls sampled for each hot path with --cycles, defaults to 100000\n"
+         "  --live              Add the table of current system to the corpus\n"
+         "  PATH...             Add dump files, or all files in directories, to the corpus\n"
+         "The corpus always has the same synthetic tables, real tables are added after them.");
+}
+
+int
+main(
+    int argc,
+    char* argv[])
+{
+    BENCH_STATE State = { 0 };
+    SMBIOS_BATCH Paths = { 0 };
+    QWORD TimeMs = BENCH_DEFAULT_TIME_MS;
+    size_t SampleCount = BENCH_DEFAULT_SAMPLES;
+    double Ns[BENCH_STAGE_COUNT], Allocations, Net;
+    bool Live = false, Cycles = false;
+    size_t i;
+    int Arg, Ret;
+
+    Ret = EINVAL;
+    for (Arg = 1; Arg < argc; Arg++)
+    {
+        if (strcmp(argv[Arg], "--time") == 0 && Arg + 1 < argc)
+        {
+            TimeMs = strtoull(argv[++Arg], NULL, 10);
+        } else if (strcmp(argv[Arg], "--cycles") == 0)
+        {
+            Cycles = true;
+        } else if (strcmp(argv[Arg], "--samples") == 0 && Arg + 1 < argc)
+        {
+            SampleCount = (size_t)strtoull(argv[++Arg], NULL, 10);
+            if (SampleCount == 0)
+            {
+                PrintUsage();
+                goto _exit;
+            }
+        } else if (strcmp(argv[Arg], "--live") == 0)
+        {
+            Live = true;
+        } else if (strncmp(argv[Arg], "--", 2) != 0)
+        {
+            if (!SmbiosAddBatchPath(&Paths, argv[Arg]))
+            {
+                printf("Add corpus path failed: %s\n", argv[Arg]);
+                goto _exit;
+            }
+        } else
+        {
+            PrintUsage();
+            goto _exit;
+        }
+    }
+
+#if defined(_WIN32) && defined(_DEBUG)
+    _CrtSetAllocHook(CountAllocation);
+#endif
+
+    Ret = ENODATA;
+    for (i = 0; i < sizeof(SyntheticTables) / sizeof(SyntheticTables[0]); i++)
+    {
+        if (!AddSyntheticTable(&State, SyntheticTables[i]))
+        {
+            printf("Generate synthetic table failed: %s\n", SyntheticTables[i]);
+            goto _exit_corpus;
+        }
+    }
+    for (i = 0; i < Paths.Count; i++)
+    {
+        if (!AddDumpTable(&State, Paths.Paths[i]))
+        {
+            printf("Load dump failed: %s\n", Paths.Paths[i]);
+            goto _exit_corpus;
+        }
+    }
+    if (Live && !AddLiveTable(&State))
+    {
+        puts("Get SMBIOS table failed");
+        goto _exit_corpus;
+    }
+
+    Ret = ENOMEM;
+    if (!SmbiosInitializeWriter(&State.Writer, NULL, BENCH_OUTPUT_BUFFER_SIZE))
+    {
+        puts("Initialize output writer failed");
+        goto _exit_corpus;
+    }
+    if (!CompileBenchPlans(&State))
+    {
+        puts("Compile decode plans failed");
+        goto _exit_writer;
+    }
+
+    printf("Corpus: %zu tables, %llu structures, %llu bytes\n",
+           State.TableCount,
+           (unsigned long long)State.StructureCount,
+           (unsigned long long)State.Length);
+    for (i = 0; i < State.TableCount; i++)
+    {
+        printf("  %-56s %8lu structures %10lu bytes\n",
+               State.Tables[i].Name,
+               (unsigned long)State.Tables[i].StructureCount,
+               (unsigned long)State.Tables[i].View.Length);
+    }
+    if (Cycles)
+    {
+        putchar('\n');
+        Ret = RunProbes(&State, SampleCount);
+        goto _exit_plans;
+    }
+
+    printf("\n%-8s %14s %10s %10s %12s  %s\n", "Stage", "ns/structure", "Net ns", "MB/s", "Allocations", "Description");
+
+    Ret = 0;
+    for (i = 0; i < BENCH_STAGE_COUNT; i++)
+    {
+        if (!RunStage(&State, &Stages[i], TimeMs, &Ns[i], &Allocations))
+        {
+            Ns[i] = 0;
+            printf("%-8s failed\n", Stages[i].Name);
+            Ret = EIO;
+            continue;
+        }
+        Net = Stages[i].Base >= 0 ? Ns[i] - Ns[Stages[i].Base] : Ns[i];
+        printf("%-8s %14.2f %10.2f %10.1f ", Stages[i].Name, Ns[i], Net, (double)State.Length * 1000.0 / (Ns[i] * (double)State.StructureCount));
+#if defined(BENCH_COUNT_ALLOCATIONS)
+        printf("%12.2f", Allocations);
+#else
+        printf("%12s", "-");
+#endif
+        printf("  %s\n", Stages[i].Description);
+    }
+    puts("\nns/structure and MB/s are over the whole corpus, Net ns excludes the stage built on, Allocations are per table");
+
+_exit_plans:
+    SmbiosFreeDecodePlans(&State.NoEnumPlans);
+    SmbiosFreeDecodePlans(&State.InterpretPlans);
+    SmbiosFreeDecodePlans(&State.Plans);
+_exit_writer:
+    SmbiosUninitializeWriter(&State.Writer);
+_exit_corpus:
+    FreeCorpus(&State);
+_exit:
+    SmbiosFreeBatch(&Paths);
+    return Ret;
+}
@@ -0,0 +1,169 @@
+﻿#include "SmbiosCache.h"
+#include "SmbiosFingerprint.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+
+#include <Windows.h>
+
+#define CacheProcessId() ((unsigned long)GetCurrentProcessId())
+#define ReplaceCacheFile(From, To) (MoveFileExA(From, To, MOVEFILE_REPLACE_EXISTING) != FALSE)
+
+#elif defined(__linux__)
+
+#include <unistd.h>
+
+#define BOOT_ID_PATH "/proc/sys/kernel/random/boot_id"
+
+#define CacheProcessId() ((unsigned long)getpid())
+#define ReplaceCacheFile(From, To) (rename(From, To) == 0)
+
+#else
+
+#error No OS target specified, currently supports Windows (_WIN32) and Linux (__linux__)
+
+#endif
+
+bool
+SmbiosGetBootId(
+    char BootId[SMBIOS_BOOT_ID_LENGTH + 4])
+{
+#if defined(__linux__)
+    FILE* File;
+    size_t Read = 0;
+
+    File = fopen(BOOT_ID_PATH, "r");
+    if (File != NULL)
+    {
+        Read = fread(BootId, 1, SMBIOS_BOOT_ID_LENGTH, File);
+        fclose(File);
+    }
+    if (Read == SMBIOS_BOOT_ID_LENGTH)
+    {
+        memset(BootId + SMBIOS_BOOT_ID_LENGTH, 0, 4);
+        return true;
+    }
+#endif
+    memset(BootId, 0, SMBIOS_BOOT_ID_LENGTH + 4);
+    return false;
+}
+
+static
+bool
+IsSameKey(
+    const SMBIOS_CACHE_KEY* Cached,
+    const SMBIOS_CACHE_KEY* Key)
+{
+    if (Cached->Variant != Key->Variant)
+    {
+        return false;
+    }
+    if (Key->BootId[0] != '\0' && memcmp(Cached->BootId, Key->BootId, sizeof(Key->BootId)) == 0)
+    {
+        return true;
+    }
+    return Key->TableHash != 0 && Cached->TableHash == Key->TableHash;
+}
+
+bool
+SmbiosLoadCache(
+    const char* Path,
+    const SMBIOS_CACHE_KEY* Key,
+    char** Output,
+    size_t* Size)
+{
+    SMBIOS_CACHE_HEADER Header;
+    FILE* File;
+    char* Buffer = NULL;
+    bool Result = false;
+
+    File = fopen(Path, "rb");
+    if (File == NULL)
+    {
+        return false;
+    }
+
+    /* Header alone tells a stale cache, output is only read if the key matches */
+    if (fread(&Header, 1, sizeof(Header), File) != sizeof(Header) ||
+        Header.Signature != SMBIOS_CACHE_SIGNATURE ||
+        Header.Version != SMBIOS_CACHE_VERSION ||
+        !IsSameKey(&Header.Key, Key) ||
+        Header.OutputSize > SIZE_MAX - 1)
+    {
+        goto _exit;
+    }
+    Buffer = (char*)malloc((size_t)Header.OutputSize + 1);
+    if (Buffer == NULL ||
+        fread(Buffer, 1, (size_t)Header.OutputSize, File) != Header.OutputSize ||
+        fgetc(File) != EOF ||
+        SmbiosHashData(Buffer, (size_t)Header.OutputSize, 0) != Header.OutputHash)
+    {
+        goto _exit;
+    }
+    *Output = Buffer;
+    *Size = (size_t)Header.OutputSize;
+    Buffer = NULL;
+    Result = true;
+
+_exit:
+    free(Buffer);
+    fclose(File);
+    return Result;
+}
+
+bool
+SmbiosSaveCache(
+    const char* Path,
+    const SMBIOS_CACHE_KEY* Key,
+    const void* Output,
+    size_t Size)
+{
+    SMBIOS_CACHE_HEADER Header;
+    FILE* File;
+    char* TempPath;
+    size_t Length;
+    bool Result;
+
+    /* Temporary file is in the same directory as renaming across file systems is not atomic */
+    Length = strlen(Path) + sizeof(".tmp.4294967295");
+    TempPath = (char*)malloc(Length);
+    if (TempPath == NULL)
+    {
+        return false;
+    }
+    snprintf(TempPath, Length, "%s.tmp.%lu", Path, CacheProcessId());
+
+    memset(&Header, 0, sizeof(Header));
+    Header.Signature = SMBIOS_CACHE_SIGNATURE;
+    Header.Version = SMBIOS_CACHE_VERSION;
+    Header.Key = *Key;
+    Header.OutputSize = Size;
+    Header.OutputHash = SmbiosHashData(Output, Size, 0);
+
+    File = fopen(TempPath, "wb");
+    if (File == NULL)
+    {
+        free(TempPath);
+        return false;
+    }
+    Result = fwrite(&Header, 1, sizeof(Header), File) == sizeof(Header) &&
+        fwrite(Output, 1, Size, File) == Size;
+    if (fclose(File) != 0)
+    {
+        Result = false;
+    }
+    if (Result)
+    {
+        Result = ReplaceCacheFile(TempPath, Path);
+    }
+    if (!Result)
+    {
+        remove(TempPath);
+    }
+    free(TempPath);
+    return Result;
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SMBIOS_CACHE_SIGNATURE      0x43424D53  // "SMBC"
+#define SMBIOS_CACHE_VERSION        1
+#define SMBIOS_BOOT_ID_LENGTH       36          // UUID in 8-4-4-4-12 form
+
+/*
+ * Version of decoder output, part of the cache key. Bump it with any change of what the same table and arguments
+ * print (e.g. text or JSON formatting, type information), so output cached by an older build is not served.
+ */
+#define SMBIOS_DECODE_OUTPUT_VERSION 1
+
+/*
+ * What a cached output depends on. The table cannot change without a reboot, so output cached in the same boot
+ * is valid without reading the table, and output cached in another boot is valid if the table hash is the same.
+ */
+typedef struct _SMBIOS_CACHE_KEY
+{
+    char BootId[SMBIOS_BOOT_ID_LENGTH + 4]; // Empty if the system has no boot ID
+    QWORD TableHash;                // SmbiosHashTable, 0 if table not read yet
+    QWORD Variant;                  // Hash of anything else the output depends on, e.g. format and query
+} SMBIOS_CACHE_KEY, *PSMBIOS_CACHE_KEY;
+
+/* Cache file header, followed by OutputSize bytes of output */
+typedef struct _SMBIOS_CACHE_HEADER
+{
+    DWORD Signature;                // SMBIOS_CACHE_SIGNATURE
+    DWORD Version;                  // SMBIOS_CACHE_VERSION
+    SMBIOS_CACHE_KEY Key;
+    QWORD OutputSize;
+    QWORD OutputHash;               // SmbiosHashData of output, tells a torn or truncated file
+} SMBIOS_CACHE_HEADER, *PSMBIOS_CACHE_HEADER;
+
+/* Boot ID of Linux (/proc/sys/kernel/random/boot_id), false and empty on other systems */
+bool
+SmbiosGetBootId(
+    char BootId[SMBIOS_BOOT_ID_LENGTH + 4]);
+
+/*
+ * Read output cached at Path if its variant is the same as Key's, and either the boot ID is the same, or the table
+ * hash is if Key has one. Output is allocated, free with free(). Returns false if missing, stale or corrupt.
+ */
+bool
+SmbiosLoadCache(
+    const char* Path,
+    const SMBIOS_CACHE_KEY* Key,
+    char** Output,
+    size_t* Size);
+
+/*
+ * Write output to a temporary file next to Path and rename it over Path, so readers see either the old or the new
+ * cache and never a partial one, even with several processes writing at the same time.
+ */
+bool
+SmbiosSaveCache(
+    const char* Path,
+    const SMBIOS_CACHE_KEY* Key,
+    const void* Output,
+    size_t Size);
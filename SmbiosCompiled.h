@@ -0,0 +1,121 @@
+﻿#pragma once
+
+/*
+ * Building blocks of visit functions generated by TypeInfoGenerator (SMBIOS.TypeDecode.h), each field of
+ * SmbiosTypeNFieldInfo becomes straight-line code with offsets, sizes and bit positions as constants.
+ * Only for SmbiosVisit.c, the generated functions are static and rely on its FindEnumValue.
+ */
+
+#include "SMBIOS.h"
+#include "SMBIOS.TypeInfo.h"
+#include "SmbiosVisit.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Visit fields of current structure, returns SmbiosVisitSkip or SmbiosVisitStop if visitor asked */
+typedef
+SMBIOS_VISIT_ACTION
+(*SMBIOS_COMPILED_VISIT_ROUTINE)(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_VISITOR* Visitor);
+
+#define SMBIOS_DEFINE_COMPILED_VISIT(Type)\
+    static\
+    SMBIOS_VISIT_ACTION\
+    SmbiosCompiledVisitType##Type(\
+        const SMBIOS_DECODE_CONTEXT* Context,\
+        const SMBIOS_VISITOR* Visitor)
+
+#define SMBIOS_COMPILED_VISIT_BEGIN(Type)\
+    typedef SMBIOS_TYPE_##Type SMBIOS_COMPILED_TYPE;\
+    PSMBIOS_FIELD_TYPE_INFO Fields = SmbiosType##Type##FieldInfo;\
+    BYTE Length = Context->Length;\
+    SMBIOS_VISIT_ACTION Action;\
+    SMBIOS_FIELD_VALUE Value;\
+    QWORD Integer = 0;\
+    const void* Parent = NULL;\
+    WORD ParentSize = 0
+
+#define SMBIOS_COMPILED_VISIT_END()\
+    (void)Integer;\
+    (void)Parent;\
+    (void)ParentSize;\
+    return SmbiosVisitContinue
+
+#define SMBIOS_COMPILED_MASK(Bits) ((Bits) >= 64 ? ~(QWORD)0 : ((QWORD)1 << (Bits)) - 1)
+#define SMBIOS_COMPILED_SIZE(Member) sizeof(((SMBIOS_COMPILED_TYPE*)0)->Member)
+
+/* A field out of the structure ends decoding */
+#define SMBIOS_COMPILED_FIELD(Index, Member)\
+    if (Length < offsetof(SMBIOS_COMPILED_TYPE, Member) + SMBIOS_COMPILED_SIZE(Member))\
+    {\
+        return SmbiosVisitContinue;\
+    }\
+    Value.Field = &Fields[Index];\
+    Value.Data = AddPtr(Context->Table, offsetof(SMBIOS_COMPILED_TYPE, Member));\
+    Value.Size = SMBIOS_COMPILED_SIZE(Member);\
+    Value.Value = 0;\
+    Value.Enum = NULL;\
+    Value.String = NULL
+
+/* Integer fields are also the parent of following bit fields */
+#define SMBIOS_COMPILED_LOAD(Member)\
+    Integer = 0;\
+    memcpy(&Integer, Value.Data, SMBIOS_COMPILED_SIZE(Member) < sizeof(QWORD) ? SMBIOS_COMPILED_SIZE(Member) : sizeof(QWORD));\
+    Parent = Value.Data;\
+    ParentSize = SMBIOS_COMPILED_SIZE(Member);\
+    Value.Value = Integer
+
+#define SMBIOS_COMPILED_CALL(Routine)\
+    if (Visitor->Routine != NULL)\
+    {\
+        Action = Visitor->Routine(Visitor->UserData, Context, &Value);\
+        if (Action != SmbiosVisitContinue)\
+        {\
+            return Action;\
+        }\
+    }
+
+#define SMBIOS_COMPILED_BITS(Index, BitOffset, BitSize)\
+    Value.Field = &Fields[Index];\
+    Value.Data = Parent;\
+    Value.Size = ParentSize;\
+    Value.Value = (Integer >> (BitOffset)) & SMBIOS_COMPILED_MASK(BitSize);\
+    Value.Enum = NULL;\
+    Value.String = NULL
+
+#define SMBIOS_DECODE_FIELD(Index, Type, Name, Member, FieldType, ...)\
+    SMBIOS_COMPILED_FIELD(Index, Member);\
+    SMBIOS_COMPILED_CALL(OnField)
+
+#define SMBIOS_DECODE_FIELD_STRING(Index, Type, Name, Member)\
+    SMBIOS_COMPILED_FIELD(Index, Member);\
+    Value.Value = *(const BYTE*)Value.Data;\
+    Value.String = SmbiosGetString(Context, (BYTE)Value.Value);\
+    SMBIOS_COMPILED_CALL(OnString)
+
+#define SMBIOS_DECODE_FIELD_UINT(Index, Type, Name, Member)\
+    SMBIOS_COMPILED_FIELD(Index, Member);\
+    SMBIOS_COMPILED_LOAD(Member);\
+    SMBIOS_COMPILED_CALL(OnField)
+
+#define SMBIOS_DECODE_FIELD_RAW(Index, Type, Name, Member) SMBIOS_DECODE_FIELD(Index, Type, Name, Member, SmbiosDataTypeRaw)
+
+#define SMBIOS_DECODE_FIELD_ENUM(Index, Type, Name, Member, EnumName)\
+    SMBIOS_COMPILED_FIELD(Index, Member);\
+    SMBIOS_COMPILED_LOAD(Member);\
+    Value.Enum = FindEnumValue(Value.Field, Value.Value);\
+    SMBIOS_COMPILED_CALL(OnField)
+
+#define SMBIOS_DECODE_BIT_FIELD(Index, Name, BitOffset, BitSize, FieldType, ...)\
+    SMBIOS_COMPILED_BITS(Index, BitOffset, BitSize);\
+    if ((FieldType) == SmbiosDataTypeEnum)\
+    {\
+        Value.Enum = FindEnumValue(Value.Field, Value.Value);\
+    }\
+    SMBIOS_COMPILED_CALL(OnField)
+
+#define SMBIOS_DECODE_FIELD_BIT(Index, Name, BitOffset)\
+    SMBIOS_COMPILED_BITS(Index, BitOffset, 1);\
+    SMBIOS_COMPILED_CALL(OnBit)
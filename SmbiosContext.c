@@ -0,0 +1,134 @@
+﻿#include "SmbiosContext.h"
+
+#include <string.h>
+
+bool
+SmbiosInitializeContext(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const void* TableData,
+    DWORD Length,
+    const SMBIOS_DECODE_PLANS* Plans)
+{
+    memset(Context, 0, sizeof(*Context));
+    Context->Plans = Plans;
+    if (!SmbiosScanTable(TableData, Length, &Context->Scan))
+    {
+        return false;
+    }
+    Context->NextTable = (PSMBIOS_TABLE)TableData;
+    return true;
+}
+
+void
+SmbiosInitializeStructureContext(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const void* StructureData,
+    DWORD Size,
+    const SMBIOS_DECODE_PLANS* Plans)
+{
+    /* Strings are set by walking the structure, clearing them would cost more than the walk */
+    Context->Scan.TableData = StructureData;
+    Context->Scan.Length = Size;
+    Context->Scan.NulBitmap = NULL;
+    Context->Table = NULL;
+    Context->NextTable = (PSMBIOS_TABLE)StructureData;
+    Context->Plans = Plans;
+    Context->StringCount = 0;
+    Context->PartialTable = false;
+    Context->Stats = NULL;
+}
+
+void
+SmbiosUninitializeContext(
+    PSMBIOS_DECODE_CONTEXT Context)
+{
+    SmbiosFreeScan(&Context->Scan);
+    Context->Table = Context->NextTable = NULL;
+}
+
+static
+bool
+NextStructure(
+    PSMBIOS_DECODE_CONTEXT Context)
+{
+    PSMBIOS_TABLE Table;
+    const void* EndOfData;
+
+    EndOfData = AddPtr(Context->Scan.TableData, Context->Scan.Length);
+    Table = Context->NextTable;
+    if (Table == NULL ||
+        SubPtr(Table, EndOfData) < sizeof(SMBIOS_HEADER) ||
+        Table->Header.Length < sizeof(SMBIOS_HEADER))
+    {
+        Context->Table = Context->NextTable = NULL;
+        return false;
+    }
+
+    Context->Table = Table;
+    Context->Offset = SubPtr(Context->Scan.TableData, Table);
+    Context->TypeInfo = SmbiosTypeInfoByType[Table->Header.Type];
+    Context->Plan = Context->Plans != NULL && Context->TypeInfo != NULL ? &Context->Plans->ByType[Table->Header.Type] : NULL;
+    if (Context->Scan.NulBitmap != NULL)
+    {
+        Context->NextTable = SmbiosScanStructure(&Context->Scan, Table, Context->Strings, &Context->StringCount);
+    } else
+    {
+        Context->NextTable = SmbiosWalkStructure(Table, EndOfData, Context->Strings, &Context->StringCount);
+    }
+    Context->Size = SubPtr(Table, Context->NextTable == NULL ? EndOfData : (const void*)Context->NextTable);
+    Context->Length = Table->Header.Length <= Context->Size ? Table->Header.Length : (BYTE)Context->Size;
+    return true;
+}
+
+/* Formatted area cut by end of table, or string-set of the last structure without its double NUL */
+static
+bool
+IsTruncatedStructure(
+    const SMBIOS_DECODE_CONTEXT* Context)
+{
+    const BYTE* Data = (const BYTE*)Context->Table;
+
+    if (Context->Length < Context->Table->Header.Length)
+    {
+        return true;
+    }
+    return Context->NextTable == NULL &&
+           (Context->Size < (DWORD)Context->Length + 2 || Data[Context->Size - 2] != 0 || Data[Context->Size - 1] != 0);
+}
+
+bool
+SmbiosNextStructure(
+    PSMBIOS_DECODE_CONTEXT Context)
+{
+    PSMBIOS_STATS Stats = Context->Stats;
+    SMBIOS_STAGE_TIMER Timer;
+    bool Result;
+
+    if (Stats == NULL)
+    {
+        return NextStructure(Context);
+    }
+    SmbiosStartStage(&Timer, Stats);
+    Result = NextStructure(Context);
+    if (Result)
+    {
+        Stats->Structures++;
+        Stats->Strings += Context->StringCount;
+        Stats->UnknownTypes += Context->TypeInfo == NULL;
+        Stats->TruncatedStructures += IsTruncatedStructure(Context);
+    }
+    SmbiosEndStage(&Timer, SmbiosStageWalk);
+    return Result;
+}
+
+const char*
+SmbiosGetString(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    BYTE Index)
+{
+    if (Index == 0 || Index > Context->StringCount)
+    {
+        return NULL;
+    }
+    return Context->Strings[Index - 1];
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+#include "SMBIOS.TypeInfo.h"
+#include "SmbiosPlan.h"
+#include "SmbiosStats.h"
+#include "SmbiosTable.h"
+
+/*
+ * Decode context holds all state of walking a table, it is owned by the caller and nothing is shared
+ * between contexts, so different tables can be decoded in different threads at the same time.
+ */
+typedef struct _SMBIOS_DECODE_CONTEXT
+{
+    SMBIOS_TABLE_SCAN Scan;         // NulBitmap is NULL in a structure context
+    PSMBIOS_TABLE Table;            // Current structure
+    PSMBIOS_TABLE NextTable;        // Next structure, NULL if current is the last one
+    DWORD Offset;                   // Offset of current structure in table data
+    bool PartialTable;              // Table data is some structures of a table, Offset is not in the firmware table
+    DWORD Size;                     // Formatted area and string-set of current structure in bytes
+    BYTE Length;                    // Formatted area to decode, less than Header.Length if the table ends in it
+    PSMBIOS_TYPE_INFO TypeInfo;     // Type information of current structure, NULL if unrecognized
+    const SMBIOS_DECODE_PLANS* Plans;
+    const SMBIOS_DECODE_PLAN* Plan; // Decode plan of current structure, NULL if unrecognized or without plans
+    BYTE StringCount;
+    const char* Strings[SMBIOS_MAX_STRINGS]; // _Field_size_(StringCount)
+    PSMBIOS_STATS Stats;            // NULL, or set after initializing to count and time the walk and visits
+} SMBIOS_DECODE_CONTEXT, *PSMBIOS_DECODE_CONTEXT;
+
+/* Plans are only needed for visiting fields, they are not copied and must outlive the context */
+bool
+SmbiosInitializeContext(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const void* TableData,
+    DWORD Length,
+    const SMBIOS_DECODE_PLANS* Plans);
+
+/*
+ * Context of a structure alone (e.g. one of a stream or a table index), the next structure is the one at
+ * StructureData. Its string-set is walked without the structural scan, so nothing is allocated and the context
+ * is cheap to make for each structure. Uninitializing it is optional.
+ */
+void
+SmbiosInitializeStructureContext(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const void* StructureData,
+    DWORD Size,
+    const SMBIOS_DECODE_PLANS* Plans);
+
+void
+SmbiosUninitializeContext(
+    PSMBIOS_DECODE_CONTEXT Context);
+
+/*
+ * Move to the first or next structure, returns false at the end of table or a header with Length less than its size,
+ * which cannot be told from the data following it. Each structure is looked at once and its string-set once,
+ * so walking a table takes time linear in its length however malformed it is.
+ */
+bool
+SmbiosNextStructure(
+    PSMBIOS_DECODE_CONTEXT Context);
+
+/* Get string by 1-based index in string field, NULL if index is 0 or out of range */
+const char*
+SmbiosGetString(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    BYTE Index);
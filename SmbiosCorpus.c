@@ -0,0 +1,514 @@
+﻿#include "SmbiosCorpus.h"
+#include "SMBIOS.TypeInfo.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CORPUS_DEFAULT_STRING_LENGTH 16
+
+static const char StringCharacters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 -._";
+
+static const char* const DefectNames[SmbiosCorpusDefectCount] = {
+    "none",
+    "zero-length",
+    "length-past-end",
+    "unterminated-strings",
+    "bad-string-index",
+    "duplicate-handle",
+    "no-end",
+    "truncated",
+};
+
+typedef struct _CORPUS_GENERATOR
+{
+    BYTE* Buffer;                   // SMBIOS_RAW_DATA header and table
+    size_t Size;
+    size_t Used;
+    QWORD State;
+    bool Failed;
+} CORPUS_GENERATOR, *PCORPUS_GENERATOR;
+
+/* SplitMix64 */
+static
+QWORD
+NextRandom(
+    PCORPUS_GENERATOR Generator)
+{
+    QWORD z;
+
+    z = (Generator->State += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Append Size bytes to table, returns NULL if out of memory */
+static
+BYTE*
+Reserve(
+    PCORPUS_GENERATOR Generator,
+    size_t Size)
+{
+    size_t NewSize;
+    BYTE* NewBuffer;
+
+    if (Generator->Failed)
+    {
+        return NULL;
+    }
+    if (Size > Generator->Size - Generator->Used)
+    {
+        NewSize = Generator->Size * 2;
+        if (NewSize - Generator->Used < Size)
+        {
+            NewSize = Generator->Used + Size;
+        }
+        NewBuffer = (BYTE*)realloc(Generator->Buffer, NewSize);
+        if (NewBuffer == NULL)
+        {
+            Generator->Failed = true;
+            return NULL;
+        }
+        Generator->Buffer = NewBuffer;
+        Generator->Size = NewSize;
+    }
+    Generator->Used += Size;
+    return Generator->Buffer + Generator->Used - Size;
+}
+
+/* Formatted area of the latest specification, from the end of the last field */
+static
+BYTE
+GetFullLength(
+    PSMBIOS_TYPE_INFO TypeInfo)
+{
+    WORD i, End, Length = sizeof(SMBIOS_HEADER);
+
+    for (i = 0; i < TypeInfo->FieldCount; i++)
+    {
+        End = TypeInfo->Fields[i].Offset + TypeInfo->Fields[i].Size;
+        if (!TypeInfo->Fields[i].IsBitField && End > Length)
+        {
+            Length = End;
+        }
+    }
+    return Length > UCHAR_MAX ? UCHAR_MAX : (BYTE)Length;
+}
+
+/* Length of an older specification version, ends at a random field */
+static
+BYTE
+GetTruncatedLength(
+    PCORPUS_GENERATOR Generator,
+    PSMBIOS_TYPE_INFO TypeInfo,
+    BYTE FullLength)
+{
+    PSMBIOS_FIELD_TYPE_INFO Field;
+    WORD End;
+
+    if (TypeInfo->FieldCount == 0)
+    {
+        return FullLength;
+    }
+    Field = &TypeInfo->Fields[NextRandom(Generator) % TypeInfo->FieldCount];
+    End = Field->IsBitField ? FullLength : Field->Offset + Field->Size;
+    return End > FullLength ? FullLength : (BYTE)End;
+}
+
+static
+void
+WriteString(
+    PCORPUS_GENERATOR Generator,
+    BYTE Length)
+{
+    BYTE* p;
+    BYTE i;
+
+    p = Reserve(Generator, (size_t)Length + 1);
+    if (p == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < Length; i++)
+    {
+        p[i] = StringCharacters[NextRandom(Generator) % (sizeof(StringCharacters) - 1)];
+    }
+    p[Length] = '\0';
+}
+
+/* Returns offset of the structure in buffer, BadStringIndex is cleared once a string field got it */
+static
+size_t
+GenerateStructure(
+    PCORPUS_GENERATOR Generator,
+    const SMBIOS_CORPUS_OPTIONS* Options,
+    BYTE Type,
+    WORD Handle,
+    bool* BadStringIndex)
+{
+    PSMBIOS_TYPE_INFO TypeInfo = SmbiosTypeInfoByType[Type];
+    PSMBIOS_FIELD_TYPE_INFO Field;
+    PSMBIOS_HEADER Header;
+    size_t Offset;
+    BYTE* Formatted;
+    BYTE Length, StringCount, i;
+    QWORD Value;
+    WORD j;
+
+    /* Unknown types get some random bytes */
+    if (TypeInfo == NULL)
+    {
+        Length = (BYTE)(sizeof(SMBIOS_HEADER) + NextRandom(Generator) % 32);
+    } else
+    {
+        Length = GetFullLength(TypeInfo);
+        if (Options->TruncateLengths)
+        {
+            Length = GetTruncatedLength(Generator, TypeInfo, Length);
+        }
+    }
+
+    Offset = Generator->Used;
+    Formatted = Reserve(Generator, Length);
+    if (Formatted == NULL)
+    {
+        return Offset;
+    }
+    for (i = sizeof(SMBIOS_HEADER); i < Length; i++)
+    {
+        Formatted[i] = (BYTE)NextRandom(Generator);
+    }
+
+    /* Strings are numbered in field order, enumerations take a defined value */
+    StringCount = 0;
+    for (j = 0; TypeInfo != NULL && j < TypeInfo->FieldCount; j++)
+    {
+        Field = &TypeInfo->Fields[j];
+        if (Field->IsBitField || Field->Offset + Field->Size > Length)
+        {
+            continue;
+        }
+        if (Field->Type == SmbiosDataTypeString && Field->Size == sizeof(BYTE))
+        {
+            if (StringCount < UCHAR_MAX - Options->ExtraStrings)
+            {
+                StringCount++;
+            }
+            Formatted[Field->Offset] = StringCount;
+            if (*BadStringIndex)
+            {
+                Formatted[Field->Offset] = UCHAR_MAX;
+                *BadStringIndex = false;
+            }
+        } else if (Field->Type == SmbiosDataTypeEnum &&
+                   Field->AdditionalInfo.Enum.Count != 0 &&
+                   Field->Size <= sizeof(QWORD))
+        {
+            Value = Field->AdditionalInfo.Enum.Values[NextRandom(Generator) % Field->AdditionalInfo.Enum.Count].Value;
+            memcpy(&Formatted[Field->Offset], &Value, Field->Size);
+        }
+    }
+
+    Header = (PSMBIOS_HEADER)Formatted;
+    Header->Type = Type;
+    Header->Length = Length;
+    Header->Handle = Handle;
+
+    /* String-set, an empty one is still double NUL */
+    StringCount += Options->ExtraStrings;
+    for (i = 0; i < StringCount; i++)
+    {
+        WriteString(Generator, Options->StringLength);
+    }
+    Formatted = Reserve(Generator, StringCount == 0 ? 2 : 1);
+    if (Formatted != NULL)
+    {
+        memset(Formatted, 0, StringCount == 0 ? 2 : 1);
+    }
+    return Offset;
+}
+
+void
+SmbiosInitializeCorpusOptions(
+    PSMBIOS_CORPUS_OPTIONS Options)
+{
+    memset(Options, 0, sizeof(*Options));
+    Options->Seed = 1;
+    Options->MajorVersion = (BYTE)(SMBIOS_VERSION >> 24);
+    Options->MinorVersion = (BYTE)(SMBIOS_VERSION >> 16);
+    Options->StringLength = CORPUS_DEFAULT_STRING_LENGTH;
+
+    /* A small server */
+    Options->Counts[0] = 1;
+    Options->Counts[1] = 1;
+    Options->Counts[2] = 1;
+    Options->Counts[3] = 1;
+    Options->Counts[4] = 2;
+    Options->Counts[7] = 6;
+    Options->Counts[9] = 4;
+    Options->Counts[16] = 1;
+    Options->Counts[17] = 16;
+    Options->Counts[19] = 1;
+    Options->Counts[32] = 1;
+    Options->Counts[127] = 1;
+}
+
+/* Structures of a type, all-types only fills in missing types so single-instance ones (e.g. Type 1) stay single */
+static
+DWORD
+CountTypeStructures(
+    const SMBIOS_CORPUS_OPTIONS* Options,
+    unsigned int Type)
+{
+    if (Options->AllTypes &&
+        Options->Counts[Type] == 0 &&
+        Type != SMBIOS_TYPE_END_OF_TABLE &&
+        SmbiosTypeInfoByType[Type] != NULL)
+    {
+        return 1;
+    }
+    return Options->Counts[Type];
+}
+
+/* Structures of the table, End-of-Table included */
+static
+QWORD
+CountStructures(
+    const SMBIOS_CORPUS_OPTIONS* Options)
+{
+    QWORD Count = 0;
+    unsigned int Type;
+
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        Count += CountTypeStructures(Options, Type);
+    }
+    return Count;
+}
+
+/* Item is "Key=..." */
+static
+bool
+IsKey(
+    const char* Item,
+    const char* Value,
+    const char* Key)
+{
+    size_t Length = Value - 1 - Item;
+
+    return strlen(Key) == Length && strncmp(Item, Key, Length) == 0;
+}
+
+bool
+SmbiosParseCorpusOptions(
+    const char* Spec,
+    PSMBIOS_CORPUS_OPTIONS Options)
+{
+    const char* Item;
+    const char* Value;
+    char* End;
+    size_t Length;
+    unsigned long long Number, Minor;
+    unsigned long Type;
+    char* Key;
+    int i;
+
+    for (Item = Spec; *Item != '\0'; Item = *End == ',' ? End + 1 : End)
+    {
+        Length = strcspn(Item, ",");
+        End = (char*)Item + Length;
+        Value = (const char*)memchr(Item, '=', Length);
+        if (Value == NULL)
+        {
+            if (Length == sizeof("all-types") - 1 && strncmp(Item, "all-types", Length) == 0)
+            {
+                Options->AllTypes = true;
+            } else if (Length == sizeof("truncate") - 1 && strncmp(Item, "truncate", Length) == 0)
+            {
+                Options->TruncateLengths = true;
+            } else if (Length != 0)
+            {
+                return false;
+            }
+            continue;
+        }
+        Value++;
+
+        if (IsKey(Item, Value, "defect"))
+        {
+            for (i = 0; i < SmbiosCorpusDefectCount; i++)
+            {
+                if (strlen(DefectNames[i]) == (size_t)(End - Value) && strncmp(Value, DefectNames[i], End - Value) == 0)
+                {
+                    break;
+                }
+            }
+            if (i == SmbiosCorpusDefectCount)
+            {
+                return false;
+            }
+            Options->Defect = (SMBIOS_CORPUS_DEFECT)i;
+            continue;
+        }
+
+        /* Everything else takes numbers */
+        Number = strtoull(Value, &End, 0);
+        if (End == Value)
+        {
+            return false;
+        }
+        if (IsKey(Item, Value, "version"))
+        {
+            if (*End != '.')
+            {
+                return false;
+            }
+            Value = End + 1;
+            Minor = strtoull(Value, &End, 10);
+            if (End == Value || Number > UCHAR_MAX || Minor > UCHAR_MAX)
+            {
+                return false;
+            }
+            Options->MajorVersion = (BYTE)Number;
+            Options->MinorVersion = (BYTE)Minor;
+        } else if (IsKey(Item, Value, "seed"))
+        {
+            Options->Seed = Number;
+        } else if (IsKey(Item, Value, "strlen") && Number != 0 && Number <= UCHAR_MAX)
+        {
+            Options->StringLength = (BYTE)Number;
+        } else if (IsKey(Item, Value, "strings") && Number < UCHAR_MAX)
+        {
+            Options->ExtraStrings = (BYTE)Number;
+        } else if (Item[0] >= '0' && Item[0] <= '9' && Number <= (DWORD)~0)
+        {
+            Type = strtoul(Item, &Key, 10);
+            if (Key != Value - 1 || Type > UCHAR_MAX)
+            {
+                return false;
+            }
+            Options->Counts[Type] = (DWORD)Number;
+        } else
+        {
+            return false;
+        }
+        if (*End != ',' && *End != '\0')
+        {
+            return false;
+        }
+    }
+    return CountStructures(Options) <= SMBIOS_CORPUS_MAX_STRUCTURES;
+}
+
+bool
+SmbiosGenerateTable(
+    const SMBIOS_CORPUS_OPTIONS* Options,
+    PSMBIOS_RAW_DATA* Data)
+{
+    CORPUS_GENERATOR Generator = { 0 };
+    PSMBIOS_RAW_DATA Header;
+    PSMBIOS_HEADER Structure;
+    QWORD Count, Index, Target;
+    size_t LastOffset = 0, TableLength;
+    unsigned int i, Type;
+    DWORD n, TypeCount;
+    WORD Handle;
+    bool BadStringIndex = false;
+
+    /* Structures are in type order with End-of-Table last, the defect goes to a random one */
+    Count = CountStructures(Options);
+    if (Count > SMBIOS_CORPUS_MAX_STRUCTURES ||
+        (Options->Defect == SmbiosCorpusDefectDuplicateHandle && Count < 2))
+    {
+        return false;
+    }
+
+    Generator.State = Options->Seed;
+    Generator.Size = 0x1000;
+    Generator.Buffer = (BYTE*)malloc(Generator.Size);
+    if (Generator.Buffer == NULL)
+    {
+        return false;
+    }
+    Reserve(&Generator, sizeof(SMBIOS_RAW_DATA));
+    if (Options->Defect == SmbiosCorpusDefectDuplicateHandle)
+    {
+        /* Repeats the handle of the structure before, so never the first one */
+        Target = 1 + NextRandom(&Generator) % (Count - 1);
+    } else
+    {
+        Target = Count != 0 ? NextRandom(&Generator) % Count : 0;
+    }
+
+    Index = 0;
+    Handle = 0;
+    for (i = 0; i <= UCHAR_MAX; i++)
+    {
+        Type = i == UCHAR_MAX ? SMBIOS_TYPE_END_OF_TABLE : i < SMBIOS_TYPE_END_OF_TABLE ? i : i + 1;
+        TypeCount = CountTypeStructures(Options, Type);
+        if (Type == SMBIOS_TYPE_END_OF_TABLE && Options->Defect == SmbiosCorpusDefectNoEndOfTable)
+        {
+            Index += TypeCount;
+            continue;
+        }
+        for (n = 0; n < TypeCount && !Generator.Failed; n++, Index++)
+        {
+            if (Index == Target && Options->Defect == SmbiosCorpusDefectBadStringIndex)
+            {
+                BadStringIndex = true;
+            }
+            LastOffset = GenerateStructure(&Generator, Options, (BYTE)Type, Handle, &BadStringIndex);
+            Structure = (PSMBIOS_HEADER)(Generator.Buffer + LastOffset);
+            if (Index == Target)
+            {
+                if (Options->Defect == SmbiosCorpusDefectZeroLength)
+                {
+                    Structure->Length = 0;
+                } else if (Options->Defect == SmbiosCorpusDefectDuplicateHandle)
+                {
+                    Handle--;
+                    Structure->Handle = Handle;
+                }
+            }
+            Handle++;
+        }
+    }
+
+    /* Defects at the end of table */
+    if (Options->Defect == SmbiosCorpusDefectLengthPastEnd && Generator.Used > LastOffset)
+    {
+        Structure = (PSMBIOS_HEADER)(Generator.Buffer + LastOffset);
+        Structure->Length = UCHAR_MAX;
+    } else if (Options->Defect == SmbiosCorpusDefectUnterminatedStrings && Generator.Used > LastOffset)
+    {
+        /* Drop the double NUL and end the table in a string */
+        Generator.Used -= 2;
+        WriteString(&Generator, Options->StringLength);
+        Generator.Used--;
+    }
+    if (Generator.Failed)
+    {
+        free(Generator.Buffer);
+        return false;
+    }
+
+    TableLength = Generator.Used - sizeof(SMBIOS_RAW_DATA);
+    if (Options->Defect == SmbiosCorpusDefectTruncatedTable && TableLength > 1)
+    {
+        TableLength = 1 + NextRandom(&Generator) % (TableLength - 1);
+    }
+    if (TableLength > (DWORD)~0)
+    {
+        free(Generator.Buffer);
+        return false;
+    }
+
+    Header = (PSMBIOS_RAW_DATA)Generator.Buffer;
+    Header->Used20CallingMethod = 0;
+    Header->SMBIOSMajorVersion = Options->MajorVersion;
+    Header->SMBIOSMinorVersion = Options->MinorVersion;
+    Header->DmiRevision = Options->MajorVersion >= 3 || TableLength > USHRT_MAX ? 3 : 2;    // As from the entry point
+    Header->Length = (DWORD)TableLength;
+    *Data = Header;
+    return true;
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+
+typedef enum _SMBIOS_CORPUS_DEFECT
+{
+    SmbiosCorpusDefectNone,
+    SmbiosCorpusDefectZeroLength,           // A structure has Length 0
+    SmbiosCorpusDefectLengthPastEnd,        // Length of the last structure goes past the end of table
+    SmbiosCorpusDefectUnterminatedStrings,  // The last string-set has no double NUL
+    SmbiosCorpusDefectBadStringIndex,       // A string field refers to a string not in the string-set
+    SmbiosCorpusDefectDuplicateHandle,      // Two structures have the same handle
+    SmbiosCorpusDefectNoEndOfTable,         // No End-of-Table (Type 127) structure
+    SmbiosCorpusDefectTruncatedTable,       // Table is cut at a random byte
+    SmbiosCorpusDefectCount
+} SMBIOS_CORPUS_DEFECT, *PSMBIOS_CORPUS_DEFECT;
+
+/* Structures of a synthetic table, handles are assigned from 0 and 0xFF00 and above are reserved */
+#define SMBIOS_CORPUS_MAX_STRUCTURES 0xFEFF
+
+/*
+ * Synthetic table, structures are laid out by type information (generated from SMBIOS.h) and filled from a
+ * seeded generator, so the same options always build the same table.
+ */
+typedef struct _SMBIOS_CORPUS_OPTIONS
+{
+    QWORD Seed;
+    BYTE MajorVersion;
+    BYTE MinorVersion;
+    DWORD Counts[UCHAR_MAX + 1];    // Structures of each type, all zero for a typical system
+    BYTE StringLength;              // Characters of each string
+    BYTE ExtraStrings;              // Strings not referenced by any field, appended to each string-set
+    bool AllTypes;                  // One structure of every type with type information and no structure yet
+    bool TruncateLengths;           // Cut Length at a random field, like structures of older specification versions
+    SMBIOS_CORPUS_DEFECT Defect;
+} SMBIOS_CORPUS_OPTIONS, *PSMBIOS_CORPUS_OPTIONS;
+
+/* Seed 1, current specification version, typical system without extra or long strings */
+void
+SmbiosInitializeCorpusOptions(
+    PSMBIOS_CORPUS_OPTIONS Options);
+
+/*
+ * Update options from a comma separated list, false if anything is unknown:
+ *   seed=N, version=MAJOR.MINOR, strlen=N, strings=N, all-types, truncate,
+ *   defect=zero-length|length-past-end|unterminated-strings|bad-string-index|duplicate-handle|no-end|truncated,
+ *   TYPE=COUNT (e.g. 17=4096), up to SMBIOS_CORPUS_MAX_STRUCTURES structures in total
+ */
+bool
+SmbiosParseCorpusOptions(
+    const char* Spec,
+    PSMBIOS_CORPUS_OPTIONS Options);
+
+/*
+ * Build a table into a new buffer with SMBIOS_RAW_DATA header, free with free(). False if it has too many structures,
+ * or too few for the defect (duplicate-handle needs two).
+ */
+bool
+SmbiosGenerateTable(
+    const SMBIOS_CORPUS_OPTIONS* Options,
+    PSMBIOS_RAW_DATA* Data);
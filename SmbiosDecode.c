@@ -1,5 +1,19 @@
 ﻿#include "SMBIOS.h"
 #include "SMBIOS.TypeInfo.h"
+#include "SmbiosBatch.h"
+#include "SmbiosCache.h"
+#include "SmbiosContext.h"
+#include "SmbiosCorpus.h"
+#include "SmbiosDiff.h"
+#include "SmbiosFingerprint.h"
+#include "SmbiosJson.h"
+#include "SmbiosLoader.h"
+#include "SmbiosQuery.h"
+#include "SmbiosStats.h"
+#include "SmbiosStream.h"
+#include "SmbiosText.h"
+#include "SmbiosVisit.h"
+#include "SmbiosWriter.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
@@ -9,395 +23,865 @@
 #include <string.h>
 #include <errno.h>
 
-#define AddPtr(P, I) ((void*)((unsigned char*)(P) + (I))) // aka Add2Ptr
-#define SubPtr(B, O) ((unsigned int)((size_t)(O) - (size_t)(B))) // aka PtrOffset
-#ifndef NULL
-#define NULL ((void *)0)
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#include <fcntl.h>
 #endif
 
-#if defined(_WIN32)
+#define STREAM_CHUNK_SIZE 0x10000
 
-#include <Windows.h>
+/* Shared by all tables decoded, read-only while decoding */
+typedef struct _DECODE_OPTIONS
+{
+    const SMBIOS_DECODE_PLANS* Plans;
+    const SMBIOS_QUERY* Query;      // NULL to decode everything
+    bool Json;
+    PSMBIOS_STATS Stats;            // NULL unless collecting statistics, which is not done in batch as it is not shared
+} DECODE_OPTIONS, *PDECODE_OPTIONS;
 
-static bool GetSmbiosTableData(PSMBIOS_RAW_DATA* Data)
+static
+void
+PrintTableHeader(
+    const SMBIOS_TABLE_VIEW* View,
+    PSMBIOS_TEXT_WRITER Writer)
 {
-    UINT BufferSize, BytesWritten;
-    PVOID Buffer;
+    SmbiosWriteString(Writer, "SMBIOS Version: ");
+    SmbiosWriteDecimal(Writer, View->SMBIOSMajorVersion, 0);
+    SmbiosWriteChar(Writer, '.');
+    SmbiosWriteDecimal(Writer, View->SMBIOSMinorVersion, 0);
+    SmbiosWriteString(Writer, "\nDMI Revision: ");
+    SmbiosWriteDecimal(Writer, View->DmiRevision, 0);
+    SmbiosWriteString(Writer, "\nData Size: ");
+    SmbiosWriteDecimal(Writer, View->Length, 0);
+    SmbiosWriteString(Writer, " bytes\n\n");
+}
 
-    BufferSize = GetSystemFirmwareTable('RSMB', 0, NULL, 0);
-    if (BufferSize == 0)
+/* Initialize context, scanning the table is timed as part of the walk if collecting statistics */
+static
+bool
+InitializeContext(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const void* TableData,
+    DWORD Length,
+    const DECODE_OPTIONS* Options)
+{
+    SMBIOS_STAGE_TIMER Timer;
+    bool Result;
+
+    SmbiosStartStage(&Timer, Options->Stats);
+    Result = SmbiosInitializeContext(Context, TableData, Length, Options->Plans);
+    SmbiosEndStage(&Timer, SmbiosStageWalk);
+    Context->Stats = Options->Stats;
+    return Result;
+}
+
+static
+bool
+DecodeTable(
+    const SMBIOS_TABLE_VIEW* View,
+    const DECODE_OPTIONS* Options,
+    PSMBIOS_TEXT_WRITER Writer)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+    SMBIOS_JSON_PRINTER JsonPrinter;
+    SMBIOS_VISITOR Printer;
+
+    /* JSON and query output have structures only */
+    if (Options->Json)
     {
-        printf("GetSystemFirmwareTable failed with: 0x%08lX\n", GetLastError());
-        return false;
+        SmbiosInitializeJsonPrinter(&JsonPrinter, Writer, &Printer);
+    } else
+    {
+        SmbiosInitializeTextPrinter(Writer, &Printer);
+        if (Options->Query == NULL)
+        {
+            PrintTableHeader(View, Writer);
+        }
     }
-    Buffer = malloc(BufferSize);
-    if (Buffer == NULL)
+    if (!InitializeContext(&Context, View->SMBIOSTableData, View->Length, Options))
     {
-        printf("malloc failed to allocate %lu bytes buffer\n", BufferSize);
+        SmbiosWriteString(Writer, "Initialize decode context failed\n");
         return false;
     }
-    BytesWritten = GetSystemFirmwareTable('RSMB', 0, Buffer, BufferSize);
-    if (BytesWritten == 0)
-    {
-        printf("GetSystemFirmwareTable failed with: 0x%08lX\n", GetLastError());
-    } else if (BytesWritten != BufferSize)
+    Context.PartialTable = View->Partial;
+
+    /* Text or JSON output is just one visitor of the decoder */
+    if (Options->Query != NULL)
     {
-        printf("Read size (%lu) is not match expected size (%lu)", BytesWritten, BufferSize);
+        SmbiosQueryTable(Options->Query, &Context, &Printer);
     } else
     {
-        *Data = (PSMBIOS_RAW_DATA)Buffer;
-        return true;
+        SmbiosVisitTable(&Context, &Printer);
     }
-
-    free(Buffer);
-    return false;
+    SmbiosUninitializeContext(&Context);
+    return true;
 }
 
-#elif defined(__linux__)
+/* SMBIOS_BATCH_ROUTINE, UserData is the shared DECODE_OPTIONS */
+static
+bool
+DecodeDumpFile(
+    void* UserData,
+    const char* Path,
+    PSMBIOS_TEXT_WRITER Writer)
+{
+    SMBIOS_TABLE_VIEW View;
+    bool Result;
 
-#include <fcntl.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <unistd.h>
+    if (!MapSmbiosTableDump(Path, &View))
+    {
+        SmbiosWriteString(Writer, "Get SMBIOS table failed\n");
+        return false;
+    }
+    Result = DecodeTable(&View, (const DECODE_OPTIONS*)UserData, Writer);
+    UnmapSmbiosTableData(&View);
+    return Result;
+}
 
-static char SmbiosEntryPointAnchorString21[] = SMBIOS_ENTRY_POINT_21_ANCHOR_STRING;
-static char SmbiosEntryPointAnchorString30[] = SMBIOS_ENTRY_POINT_30_ANCHOR_STRING;
+typedef struct _STREAM_DECODE
+{
+    const DECODE_OPTIONS* Options;
+    const SMBIOS_VISITOR* Printer;
+} STREAM_DECODE, *PSTREAM_DECODE;
 
-static bool ReadSmbiosEntryField(int fd, off_t off, void* p, size_t len)
+/* SMBIOS_STREAM_ROUTINE, each structure is decoded as a table of its own but keeps its offset in the stream */
+static
+bool
+DecodeStreamStructure(
+    void* UserData,
+    PSMBIOS_TABLE Table,
+    DWORD Offset,
+    DWORD Size)
 {
-    if (lseek(fd, off, SEEK_SET) == (off_t)-1)
+    const STREAM_DECODE* Decode = (const STREAM_DECODE*)UserData;
+    SMBIOS_DECODE_CONTEXT Context;
+    SMBIOS_VISIT_ACTION Action = SmbiosVisitContinue;
+
+    SmbiosInitializeStructureContext(&Context, Table, Size, Decode->Options->Plans);
+    Context.Stats = Decode->Options->Stats;
+    if (SmbiosNextStructure(&Context))
     {
-        return false;
+        Context.Offset = Offset;
+        if (Decode->Options->Query != NULL)
+        {
+            Action = SmbiosQueryStructure(Decode->Options->Query, &Context, Decode->Printer);
+        } else
+        {
+            Action = SmbiosVisitStructure(&Context, Decode->Printer);
+        }
     }
-    return read(fd, p, len) == len;
+    return Action != SmbiosVisitStop;
 }
 
-static bool GetSmbiosTableData(PSMBIOS_RAW_DATA* Data)
+/* Decode a bare table (e.g. DMI) read from File in chunks, only the largest structure is buffered */
+static
+bool
+DecodeStream(
+    FILE* File,
+    const DECODE_OPTIONS* Options,
+    PSMBIOS_TEXT_WRITER Writer)
 {
-    int fd, ret;
-    struct stat sb;
-    PSMBIOS_RAW_DATA p;
-    ssize_t size, i;
-    char anchor[5];
-
-    fd = open("/sys/firmware/dmi/tables/DMI", O_RDONLY);
-    if (fd < 0)
+    SMBIOS_STREAM_PARSER Parser = { 0 };
+    STREAM_DECODE Decode;
+    SMBIOS_JSON_PRINTER JsonPrinter;
+    SMBIOS_VISITOR Printer;
+    SMBIOS_STAGE_TIMER Timer;
+    BYTE* Chunk;
+    size_t Read;
+    bool Result;
+
+    Chunk = (BYTE*)malloc(STREAM_CHUNK_SIZE);
+    if (Chunk == NULL)
     {
-        printf("open failed with: %d\n", errno);
+        SmbiosWriteString(Writer, "Allocate stream buffer failed\n");
         return false;
     }
-    ret = fstat(fd, &sb);
-    if (ret < 0)
+    if (Options->Json)
     {
-        printf("fstat failed with: %d\n", errno);
-        goto _exit_0;
-    }
-    size = sizeof(SMBIOS_RAW_DATA) + sb.st_size;
-    p = (PSMBIOS_RAW_DATA)malloc(size);
-    if (p == NULL)
+        SmbiosInitializeJsonPrinter(&JsonPrinter, Writer, &Printer);
+    } else
     {
-        printf("malloc failed to allocate %zd bytes buffer\n", size);
-        goto _exit_0;
+        SmbiosInitializeTextPrinter(Writer, &Printer);
     }
-
-    size = 0;
-    do
+    Decode.Options = Options;
+    Decode.Printer = &Printer;
+    Parser.Routine = DecodeStreamStructure;
+    Parser.UserData = &Decode;
+    for (;;)
     {
-        i = read(fd, AddPtr(p, sizeof(SMBIOS_RAW_DATA) + size), sb.st_size - size);
-        if (i < 0)
+        /* Reading is the load stage, parsing in between is the walk with decoding of structures found */
+        SmbiosStartStage(&Timer, Options->Stats);
+        Read = fread(Chunk, 1, STREAM_CHUNK_SIZE, File);
+        SmbiosEndStage(&Timer, SmbiosStageLoad);
+        if (Read == 0)
         {
-            printf("read failed with: %d\n", errno);
-            goto _exit_1;
+            break;
+        }
+        if (Options->Stats != NULL)
+        {
+            Options->Stats->BytesRead += Read;
         }
-        size += i;
-    } while (i > 0);
-    if (size != sb.st_size)
+        Result = SmbiosFeedStreamParser(&Parser, Chunk, Read);
+        SmbiosEndStage(&Timer, SmbiosStageWalk);
+        if (!Result)
+        {
+            break;
+        }
+    }
+    SmbiosStartStage(&Timer, Options->Stats);
+    Result = SmbiosFinishStreamParser(&Parser) && !ferror(File);
+    SmbiosEndStage(&Timer, SmbiosStageWalk);
+    free(Chunk);
+    if (!Result)
     {
-        printf("Read size (%zd) is not match expected size (%ld)\n", size, sb.st_size);
-        goto _exit_1;
+        SmbiosWriteString(Writer, "Parse SMBIOS table stream failed\n");
     }
-    close(fd);
+    return Result;
+}
 
-    fd = open("/sys/firmware/dmi/tables/smbios_entry_point", O_RDONLY);
-    if (fd < 0)
+/* Hash of the whole table, then of each structure by handle */
+static
+bool
+PrintFingerprint(
+    const SMBIOS_TABLE_VIEW* View,
+    PSMBIOS_TEXT_WRITER Writer)
+{
+    SMBIOS_FINGERPRINT Fingerprint;
+    DWORD i;
+
+    if (!SmbiosFingerprintTable(View->SMBIOSTableData, View->Length, &Fingerprint))
     {
-        printf("open failed with: %d\n", errno);
-        free(p);
+        SmbiosWriteString(Writer, "Fingerprint table failed\n");
         return false;
     }
-    i = read(fd, anchor, sizeof(anchor));
-    if (i != sizeof(anchor))
+    SmbiosWriteString(Writer, "Table Hash: ");
+    SmbiosWriteHex(Writer, Fingerprint.TableHash, 16);
+    SmbiosWriteString(Writer, "\nStable Hash: ");
+    SmbiosWriteHex(Writer, Fingerprint.StableHash, 16);
+    SmbiosWriteString(Writer, "\nStructures: ");
+    SmbiosWriteDecimal(Writer, Fingerprint.Count, 0);
+    SmbiosWriteString(Writer, "\n\nHandle  Type  Hash\n");
+    for (i = 0; i < Fingerprint.Count; i++)
     {
-        goto _exit_2;
+        SmbiosWriteString(Writer, "0x");
+        SmbiosWriteHex(Writer, Fingerprint.Structures[i].Handle, 4);
+        SmbiosWriteString(Writer, "  ");
+        SmbiosWriteDecimal(Writer, Fingerprint.Structures[i].Type, 0);
+        SmbiosWriteString(Writer, Fingerprint.Structures[i].Type < 10 ? "     " : (Fingerprint.Structures[i].Type < 100 ? "    " : "   "));
+        SmbiosWriteHex(Writer, Fingerprint.Structures[i].Hash, 16);
+        SmbiosWriteChar(Writer, '\n');
     }
-    if (memcmp(anchor, SmbiosEntryPointAnchorString30, sizeof(SmbiosEntryPointAnchorString30)) == 0)
-    {
-        if (!ReadSmbiosEntryField(fd, offsetof(SMBIOS_ENTRY_POINT_30, MajorVersion), &p->SMBIOSMajorVersion, sizeof(p->SMBIOSMajorVersion)) ||
-            !ReadSmbiosEntryField(fd, offsetof(SMBIOS_ENTRY_POINT_30, MinorVersion), &p->SMBIOSMinorVersion, sizeof(p->SMBIOSMajorVersion)) ||
-            !ReadSmbiosEntryField(fd, offsetof(SMBIOS_ENTRY_POINT_30, TableMaxSize), &p->Length, sizeof(p->Length)))
-        {
-            goto _exit_2;
-        }
-        p->DmiRevision = 3;
-    } else if (memcmp(anchor, SmbiosEntryPointAnchorString21, sizeof(SmbiosEntryPointAnchorString21)) == 0)
-    {
-        WORD len;
+    SmbiosFreeFingerprint(&Fingerprint);
+    return true;
+}
 
-        if (!ReadSmbiosEntryField(fd, offsetof(SMBIOS_ENTRY_POINT_21, MajorVersion), &p->SMBIOSMajorVersion, sizeof(p->SMBIOSMajorVersion)) ||
-            !ReadSmbiosEntryField(fd, offsetof(SMBIOS_ENTRY_POINT_21, MinorVersion), &p->SMBIOSMinorVersion, sizeof(p->SMBIOSMajorVersion)) ||
-            !ReadSmbiosEntryField(fd, offsetof(SMBIOS_ENTRY_POINT_21, TableLength), &len, sizeof(len)))
-        {
-            goto _exit_2;
-        }
-        p->Length = len;
-        p->DmiRevision = 2;
+typedef struct _DIFF_PRINTER
+{
+    PSMBIOS_TEXT_WRITER Writer;
+    SMBIOS_VISITOR Printer;         // Text printer for field lines
+    DWORD Counts[SmbiosStructureChanged + 1]; // By SMBIOS_FINGERPRINT_CHANGE
+} DIFF_PRINTER, *PDIFF_PRINTER;
+
+/* SMBIOS_DIFF_STRUCTURE_ROUTINE, one line of "+", "-" or "~" with type and handle, "OLD -> NEW" if renumbered */
+static
+SMBIOS_VISIT_ACTION
+PrintDiffStructure(
+    void* UserData,
+    SMBIOS_FINGERPRINT_CHANGE Change,
+    const SMBIOS_DECODE_CONTEXT* Old,
+    const SMBIOS_DECODE_CONTEXT* New)
+{
+    PDIFF_PRINTER Diff = (PDIFF_PRINTER)UserData;
+    const SMBIOS_DECODE_CONTEXT* Context = New != NULL ? New : Old;
+
+    Diff->Counts[Change]++;
+    SmbiosWriteString(Diff->Writer, Change == SmbiosStructureAdded ? "+ " : (Change == SmbiosStructureRemoved ? "- " : "~ "));
+    SmbiosWriteString(Diff->Writer, "[Type ");
+    SmbiosWriteDecimal(Diff->Writer, Context->Table->Header.Type, 0);
+    if (Context->TypeInfo != NULL)
+    {
+        SmbiosWriteString(Diff->Writer, ": ");
+        SmbiosWriteString(Diff->Writer, Context->TypeInfo->Name);
+        SmbiosWriteString(Diff->Writer, "] Handle: 0x");
     } else
     {
-        goto _exit_2;
+        SmbiosWriteString(Diff->Writer, " (Unrecognized)] Handle: 0x");
     }
-    p->Used20CallingMethod = 0;
+    if (Old != NULL && New != NULL && Old->Table->Header.Handle != New->Table->Header.Handle)
+    {
+        SmbiosWriteHex(Diff->Writer, Old->Table->Header.Handle, 4);
+        SmbiosWriteString(Diff->Writer, " -> 0x");
+    }
+    SmbiosWriteHex(Diff->Writer, Context->Table->Header.Handle, 4);
+    SmbiosWriteChar(Diff->Writer, '\n');
+    return SmbiosVisitContinue;
+}
 
-    *Data = p;
-    return true;
+/* SMBIOS_DIFF_FIELD_ROUTINE, old and new lines of the field as the text printer writes them */
+static
+SMBIOS_VISIT_ACTION
+PrintDiffField(
+    void* UserData,
+    SMBIOS_DECODE_STEP_KIND Kind,
+    const SMBIOS_DECODE_CONTEXT* Old,
+    const SMBIOS_FIELD_VALUE* OldValue,
+    const SMBIOS_DECODE_CONTEXT* New,
+    const SMBIOS_FIELD_VALUE* NewValue)
+{
+    PDIFF_PRINTER Diff = (PDIFF_PRINTER)UserData;
+    SMBIOS_VISIT_FIELD_ROUTINE Routine;
 
-_exit_2:
-    puts("Read SMBIOS entry point failed\n");
-_exit_1:
-    free(p);
-_exit_0:
-    close(fd);
-    return false;
+    Routine = Kind == SmbiosDecodeStepString ? Diff->Printer.OnString : (Kind == SmbiosDecodeStepBit ? Diff->Printer.OnBit : Diff->Printer.OnField);
+    if (OldValue != NULL)
+    {
+        SmbiosWriteString(Diff->Writer, "  - ");
+        Routine(Diff->Printer.UserData, Old, OldValue);
+    }
+    if (NewValue != NULL)
+    {
+        SmbiosWriteString(Diff->Writer, "  + ");
+        Routine(Diff->Printer.UserData, New, NewValue);
+    }
+    return SmbiosVisitContinue;
 }
 
-#else
-
-#error No OS target specified, currently supports Windows (_WIN32) and Linux (__linux__)
+/* Structures added, removed and changed from the table of one dump file to another's */
+static
+bool
+DiffDumpFiles(
+    const char* OldPath,
+    const char* NewPath,
+    const SMBIOS_DECODE_PLANS* Plans,
+    PSMBIOS_TEXT_WRITER Writer)
+{
+    SMBIOS_TABLE_VIEW Old, New;
+    SMBIOS_DIFF_VISITOR Visitor;
+    DIFF_PRINTER Diff = { 0 };
+    bool Result = false;
 
-#endif
+    if (!MapSmbiosTableDump(OldPath, &Old))
+    {
+        SmbiosWriteString(Writer, "Get old SMBIOS table failed\n");
+        return false;
+    }
+    if (!MapSmbiosTableDump(NewPath, &New))
+    {
+        SmbiosWriteString(Writer, "Get new SMBIOS table failed\n");
+        goto _exit_old;
+    }
 
-static const char* g_Strings[UCHAR_MAX] = { 0 };
+    Diff.Writer = Writer;
+    SmbiosInitializeTextPrinter(Writer, &Diff.Printer);
+    Visitor.UserData = &Diff;
+    Visitor.OnStructure = PrintDiffStructure;
+    Visitor.OnField = PrintDiffField;
+    Visitor.OnStructureEnd = NULL;
+    if (!SmbiosDiffTables(Old.SMBIOSTableData, Old.Length, New.SMBIOSTableData, New.Length, Plans, &Visitor))
+    {
+        SmbiosWriteString(Writer, "Compare SMBIOS tables failed\n");
+        goto _exit_new;
+    }
+    SmbiosWriteString(Writer, "\nAdded: ");
+    SmbiosWriteDecimal(Writer, Diff.Counts[SmbiosStructureAdded], 0);
+    SmbiosWriteString(Writer, ", Removed: ");
+    SmbiosWriteDecimal(Writer, Diff.Counts[SmbiosStructureRemoved], 0);
+    SmbiosWriteString(Writer, ", Changed: ");
+    SmbiosWriteDecimal(Writer, Diff.Counts[SmbiosStructureChanged], 0);
+    SmbiosWriteChar(Writer, '\n');
+    Result = true;
+
+_exit_new:
+    UnmapSmbiosTableData(&New);
+_exit_old:
+    UnmapSmbiosTableData(&Old);
+    return Result;
+}
 
+/* Key of --cache, output depends on all arguments but the cache path, and on the output version of the decoder */
 static
-PSMBIOS_TABLE
-PrintSmbiosTable(
-    PSMBIOS_TABLE Table,
-    void* StartOfData,
-    void* EndOfData)
+void
+GetCacheKey(
+    int argc,
+    char* argv[],
+    PSMBIOS_CACHE_KEY Key)
 {
-    PSMBIOS_TABLE NextTable;
-    void* EndOfTable;
-    WORD i;
-    const char *psz;
-    BYTE StringCount;
-    size_t MaxSize, Length;
-    PSMBIOS_TYPE_INFO TypeInfo;
-    QWORD BitFieldValue, Value;
-    WORD BitFieldSize = 0, ValueSize;
-
-    /* Get type information */
-    TypeInfo = NULL;
-    for (i = 0; i < sizeof(SmbiosTypeInfo) / sizeof(SmbiosTypeInfo[0]); i++)
-    {
-        if (SmbiosTypeInfo[i].Type == Table->Header.Type)
-        {
-            TypeInfo = &SmbiosTypeInfo[i];
-            break;
-        }
-    }
+    int i;
 
-    /* Build string index array and locate next table address */
-    psz = (const char *)AddPtr(Table, Table->Header.Length);
-    StringCount = 0;
-    NextTable = NULL;
-    while (true)
+    memset(Key, 0, sizeof(*Key));
+    SmbiosGetBootId(Key->BootId);
+    Key->Variant = SMBIOS_DECODE_OUTPUT_VERSION;
+    for (i = 1; i < argc; i++)
     {
-        if (psz + 2 >= (const char*)EndOfData)
+        if (strcmp(argv[i], "--cache") == 0)
         {
-            break;
-        }
-        if (psz[0] == '\0' && psz[1] == '\0')
-        {
-            NextTable = (PSMBIOS_TABLE)(psz + 2);
-            break;
+            i++;
+            continue;
         }
+        Key->Variant = SmbiosHashData(argv[i], strlen(argv[i]) + 1, Key->Variant);
+    }
+}
 
-        MaxSize = SubPtr(psz, EndOfData);
-        Length = strnlen(psz, MaxSize);
-        if (Length == MaxSize)
-        {
-            break;
-        }
-        g_Strings[StringCount++] = psz;
-        psz += Length + 1;
-        if (psz[0] == '\0')
-        {
-            NextTable = (PSMBIOS_TABLE)(psz + 1);
-            break;
-        }
+/* Write output cached for Key, and cache it again for this boot if it was found by table hash of another boot */
+static
+bool
+PrintCachedOutput(
+    const char* Path,
+    const SMBIOS_CACHE_KEY* Key)
+{
+    char* Output;
+    size_t Size;
+
+    if (!SmbiosLoadCache(Path, Key, &Output, &Size))
+    {
+        return false;
     }
-    if ((void*)NextTable >= EndOfData)
+    fwrite(Output, 1, Size, stdout);
+    if (Key->TableHash != 0 && Key->BootId[0] != '\0')
     {
-        NextTable = NULL;
+        SmbiosSaveCache(Path, Key, Output, Size);
     }
-    EndOfTable = NextTable == NULL ? EndOfData : NextTable;
+    free(Output);
+    return true;
+}
 
-    /* Print table header */
-    if (TypeInfo != NULL)
-    {
-        printf("[Type %hhu: %s]\n", Table->Header.Type, TypeInfo->Name);
-    } else
+/* Summary of --stats, on standard error so output can still be piped */
+static
+void
+PrintStats(
+    const SMBIOS_STATS* Stats)
+{
+    QWORD Total;
+    int i;
+
+    Total = SmbiosGetStatsTime(Stats);
+    fprintf(stderr, "Stage       Time (ms)   Share\n");
+    for (i = 0; i < SmbiosStageCount; i++)
     {
-        printf("[Type %hhu (Unrecognized)]\n", Table->Header.Type);
+        fprintf(stderr, "%-8s %12.3f %6.1f%%\n", SmbiosStageNames[i], Stats->Nanoseconds[i] / 1e6,
+                Total != 0 ? Stats->Nanoseconds[i] * 100.0 / Total : 0.0);
     }
-    printf("Handle: 0x%04hX, Offset: 0x%08X, Length: 0x%02hhX bytes, Total: 0x%X bytes\n",
-           Table->Header.Handle,
-           SubPtr(StartOfData, Table),
-           Table->Header.Length,
-           SubPtr(Table, EndOfTable));
+    fprintf(stderr, "%-8s %12.3f\n\n", "total", Total / 1e6);
+    fprintf(stderr, "Bytes read:           %llu\n", Stats->BytesRead);
+    fprintf(stderr, "Structures:           %llu\n", Stats->Structures);
+    fprintf(stderr, "Strings:              %llu\n", Stats->Strings);
+    fprintf(stderr, "Fields:               %llu\n", Stats->Fields);
+    fprintf(stderr, "Unknown types:        %llu\n", Stats->UnknownTypes);
+    fprintf(stderr, "Truncated structures: %llu\n", Stats->TruncatedStructures);
+    fprintf(stderr, "Bytes written:        %llu\n", Stats->BytesWritten);
+}
 
-    /* Print table fields */
-    if (TypeInfo == NULL)
+/* Compile decode plans, and the query if any term was given */
+static
+bool
+CompileDecodeOptions(
+    PDECODE_OPTIONS Options,
+    PSMBIOS_DECODE_PLANS Plans,
+    PSMBIOS_QUERY Query)
+{
+    if (!SmbiosCompileDecodePlans(Plans))
+    {
+        return false;
+    }
+    if (Query->Count != 0)
     {
-        goto _Exit;
+        if (!SmbiosCompileQuery(Query, Plans))
+        {
+            SmbiosFreeDecodePlans(Plans);
+            return false;
+        }
+        Options->Query = Query;
     }
-    for (i = 0; i < TypeInfo->FieldCount; i++)
+    Options->Plans = Plans;
+    return true;
+}
+
+static
+void
+PrintUsage(void)
+{
+    puts("Usage: SmbiosDecode [--json] [--stats] [QUERY...] [--dump-bin FILE] [--from-dump FILE [ENTRY_POINT_FILE]]\n"
+         "       SmbiosDecode [--json] [--stats] [QUERY...] [--dump-bin FILE] --generate SPEC\n"
+         "       SmbiosDecode [--json] [--stats] [QUERY...] [--dump-bin FILE] --from-image FILE [BASE]\n"
+         "       SmbiosDecode [--json] [--stats] [QUERY...] --from-stream FILE\n"
+         "       SmbiosDecode --cache FILE [--json] [QUERY...]\n"
+         "       SmbiosDecode --fingerprint [--from-dump FILE [ENTRY_POINT_FILE] | --from-image FILE [BASE] | --generate SPEC]\n"
+         "       SmbiosDecode --diff OLD_DUMP_FILE NEW_DUMP_FILE\n"
+         "       SmbiosDecode --batch [--json] [QUERY...] [--jobs N] [--output-dir DIR] PATH...\n"
+         "  --json              Write structures as NDJSON, one object per line\n"
+         "  --stats             Print time of each stage (load, walk, decode, output) and counters to standard error\n"
+         "  --type N            Query: decode only structures of type N\n"
+         "  --handle N          Query: decode only the structure with handle N (e.g. 0x0100)\n"
+         "  --field N.NAME      Query: decode only field NAME of type N (e.g. 1.UUID, 17.Speed)\n"
+         "  --dump-bin FILE     Write entry point and table to a binary dump file instead of decoding\n"
+         "  --from-dump FILE    Decode a binary dump file instead of the live table,\n"
+         "                      or a table file (e.g. DMI) with its entry point file (e.g. smbios_entry_point)\n"
+         "  --generate SPEC     Decode a synthetic table instead of the live table, SPEC is \"default\" or a comma\n"
+         "                      separated list of seed=N, version=M.m, strlen=N, strings=N, all-types, truncate,\n"
+         "                      TYPE=COUNT (e.g. 17=4096, up to 65279 structures in total) and defect=zero-length|\n"
+         "                      length-past-end|unterminated-strings|bad-string-index|duplicate-handle|no-end|truncated\n"
+         "  --from-image FILE   Decode the table found by entry point in a raw image of firmware or memory (e.g. a\n"
+         "                      BIOS region dump or VM memory snapshot), BASE is the physical address of the image\n"
+         "                      start, 0 by default\n"
+         "  --from-stream FILE  Decode a table file (e.g. DMI) while reading it, \"-\" for standard input\n"
+         "  --fingerprint       Print hash of the table and of each structure instead of decoding,\n"
+         "                      structure hashes leave out volatile fields (e.g. event log change token)\n"
+         "  --diff OLD NEW      Print structures added, removed and changed between tables of two dump files,\n"
+         "                      paired by handle or else by type and instance order, and fields that changed\n"
+         "  --cache FILE        Decode the live table once per boot, or once per table if it is the same after\n"
+         "                      reboot, and write the output cached in FILE until then\n"
+         "  --batch PATH...     Decode dump files, or all files in directories, in parallel,\n"
+         "                      output is in input order\n"
+         "  --jobs N            Number of worker threads from 1 to 1024, defaults to number of processors\n"
+         "  --output-dir DIR    Write output of each input to DIR/<input file name>.txt (.json) instead");
+}
+
+int
+main(
+    int argc,
+    char* argv[])
+{
+    SMBIOS_TABLE_VIEW View;
+    SMBIOS_CORPUS_OPTIONS CorpusOptions;
+    PSMBIOS_RAW_DATA Data;
+    SMBIOS_DECODE_PLANS Plans;
+    SMBIOS_QUERY Query = { 0 };
+    SMBIOS_STATS Stats = { 0 };
+    SMBIOS_STAGE_TIMER Timer;
+    SMBIOS_CACHE_KEY CacheKey;
+    DECODE_OPTIONS Options = { NULL, NULL, false, NULL };
+    SMBIOS_TEXT_WRITER Writer;
+    SMBIOS_BATCH Batch = { 0 };
+    const char* DumpPath = NULL;
+    const char* FromDumpPath = NULL;
+    const char* EntryPointPath = NULL;
+    const char* StreamPath = NULL;
+    const char* ImagePath = NULL;
+    QWORD ImageBase = 0;
+    const char* CorpusSpec = NULL;
+    const char* CachePath = NULL;
+    const char* DiffOldPath = NULL;
+    const char* DiffNewPath = NULL;
+    FILE* Stream;
+    bool BatchMode = false, Fingerprint = false, Mapped;
+    bool Types[UCHAR_MAX + 1];
+    unsigned long Value;
+    char* End;
+    int i, Ret;
+
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    setlocale(LC_ALL, ".UTF-8");
+
+    Ret = EINVAL;
+    for (i = 1; i < argc; i++)
     {
-        Value = 0;
-        if (TypeInfo->Fields[i].IsBitField)
+        if (strcmp(argv[i], "--dump-bin") == 0 && i + 1 < argc)
+        {
+            DumpPath = argv[++i];
+        } else if (strcmp(argv[i], "--from-dump") == 0 && i + 1 < argc)
         {
-            if (BitFieldSize == 0)
+            FromDumpPath = argv[++i];
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
             {
-                if (i == 0 ||
-                    TypeInfo->Fields[i - 1].IsBitField ||
-                    TypeInfo->Fields[i - 1].Type != SmbiosDataTypeUInt)
+                EntryPointPath = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--from-image") == 0 && i + 1 < argc)
+        {
+            ImagePath = argv[++i];
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+            {
+                ImageBase = strtoull(argv[++i], &End, 0);
+                if (*End != '\0')
                 {
-                    break;
+                    goto _usage;
                 }
-                BitFieldSize = TypeInfo->Fields[i - 1].Size;
-                BitFieldValue = 0;
-                memcpy(&BitFieldValue, AddPtr(Table, TypeInfo->Fields[i - 1].Offset), TypeInfo->Fields[i - 1].Size);
             }
-            putchar('\t');
-            if (TypeInfo->Fields[i].Type == SmbiosDataTypeBit)
-            {
-                printf("%02hhu [%c] %s",
-                       (BYTE)TypeInfo->Fields[i].Offset,
-                       (BitFieldValue & ((QWORD)1 << TypeInfo->Fields[i].Offset)) ? 'x' : ' ',
-                       TypeInfo->Fields[i].Name);
-            } else if (TypeInfo->Fields[i].Type == SmbiosDataTypeUInt || TypeInfo->Fields[i].Type == SmbiosDataTypeEnum)
+        } else if (strcmp(argv[i], "--from-stream") == 0 && i + 1 < argc)
+        {
+            StreamPath = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc)
+        {
+            CorpusSpec = argv[++i];
+        } else if (strcmp(argv[i], "--diff") == 0 && i + 2 < argc)
+        {
+            DiffOldPath = argv[++i];
+            DiffNewPath = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            CachePath = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0)
+        {
+            Options.Json = true;
+        } else if (strcmp(argv[i], "--fingerprint") == 0)
+        {
+            Fingerprint = true;
+        } else if (strcmp(argv[i], "--stats") == 0)
+        {
+            Options.Stats = &Stats;
+        } else if (strcmp(argv[i], "--type") == 0 && i + 1 < argc)
+        {
+            Value = strtoul(argv[++i], &End, 0);
+            if (*End != '\0' || Value > UCHAR_MAX || !SmbiosAddQueryType(&Query, (BYTE)Value))
             {
-                printf("%02hhu:%02hhu %s: ",
-                       (BYTE)TypeInfo->Fields[i].Offset,
-                       (BYTE)TypeInfo->Fields[i].Offset + TypeInfo->Fields[i].Size - 1,
-                       TypeInfo->Fields[i].Name);
-                Value = BitFieldValue;
-                Value >>= TypeInfo->Fields[i].Offset;
-                Value &= ((QWORD)1 << TypeInfo->Fields[i].Size) - 1;
+                goto _usage;
             }
-        } else
+        } else if (strcmp(argv[i], "--handle") == 0 && i + 1 < argc)
         {
-            if (TypeInfo->Fields[i].Offset + TypeInfo->Fields[i].Size > Table->Header.Length)
+            Value = strtoul(argv[++i], &End, 0);
+            if (*End != '\0' || Value > USHRT_MAX || !SmbiosAddQueryHandle(&Query, (WORD)Value))
             {
-                break;
+                goto _usage;
             }
-            BitFieldSize = 0;
-            printf("0x%04hX %s: ", TypeInfo->Fields[i].Offset, TypeInfo->Fields[i].Name);
-        }
-
-        if (TypeInfo->Fields[i].Type == SmbiosDataTypeString && TypeInfo->Fields[i].Size == sizeof(BYTE))
+        } else if (strcmp(argv[i], "--field") == 0 && i + 1 < argc)
         {
-            BYTE Index = *(BYTE*)AddPtr(Table, TypeInfo->Fields[i].Offset);
-            if (Index != 0 && Index <= StringCount)
+            if (!SmbiosAddQueryField(&Query, argv[++i]))
             {
-                printf("0x%02hhX \"%s\"", Index, g_Strings[(BYTE)(Index - 1)]);
+                printf("Unknown field: %s\n", argv[i]);
+                goto _exit_batch;
             }
-        } else if (TypeInfo->Fields[i].Type == SmbiosDataTypeUInt || TypeInfo->Fields[i].Type == SmbiosDataTypeEnum)
+        } else if (strcmp(argv[i], "--batch") == 0)
         {
-            if (TypeInfo->Fields[i].IsBitField)
-            {
-                ValueSize = BitFieldSize;
-            } else
+            BatchMode = true;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+        {
+            Value = strtoul(argv[++i], &End, 10);
+            if (*End != '\0' || End == argv[i] || Value == 0 || Value > SMBIOS_BATCH_MAX_THREADS)
             {
-                Value = 0;
-                memcpy(&Value, AddPtr(Table, TypeInfo->Fields[i].Offset), TypeInfo->Fields[i].Size);
-                ValueSize = TypeInfo->Fields[i].Size;
+                goto _usage;
             }
-            if (ValueSize == sizeof(BYTE))
-            {
-                printf("0x%02hhX", (BYTE)Value);
-            } else if (ValueSize == sizeof(WORD))
-            {
-                printf("0x%04hX", (WORD)Value);
-            } else if (ValueSize == sizeof(DWORD))
-            {
-                printf("0x%08lX", (DWORD)Value);
-            } else if (ValueSize == sizeof(QWORD))
+            Batch.Threads = (unsigned int)Value;
+        } else if (strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc)
+        {
+            Batch.OutputDirectory = argv[++i];
+        } else if (strncmp(argv[i], "--", 2) != 0)
+        {
+            if (!SmbiosAddBatchPath(&Batch, argv[i]))
             {
-                printf("0x%016llX", Value);
+                puts("Add batch input failed");
+                goto _exit_batch;
             }
-            if (TypeInfo->Fields[i].Type == SmbiosDataTypeEnum)
+        } else
+        {
+            goto _usage;
+        }
+    }
+    if (BatchMode != (Batch.Count != 0) ||
+        (BatchMode && (DumpPath != NULL || FromDumpPath != NULL || CorpusSpec != NULL || Options.Stats != NULL)) ||
+        (StreamPath != NULL && (BatchMode || DumpPath != NULL || FromDumpPath != NULL || CorpusSpec != NULL)) ||
+        (CorpusSpec != NULL && FromDumpPath != NULL) ||
+        (ImagePath != NULL && (BatchMode || StreamPath != NULL || FromDumpPath != NULL || CorpusSpec != NULL)) ||
+        (Fingerprint && (BatchMode || StreamPath != NULL || DumpPath != NULL)) ||
+        (DiffOldPath != NULL && (BatchMode || StreamPath != NULL || DumpPath != NULL || FromDumpPath != NULL ||
+                                 CorpusSpec != NULL || ImagePath != NULL || Fingerprint || Options.Json || Options.Stats != NULL ||
+                                 Query.Count != 0)) ||
+        (CachePath != NULL && (BatchMode || StreamPath != NULL || DumpPath != NULL || FromDumpPath != NULL ||
+                               CorpusSpec != NULL || ImagePath != NULL || Fingerprint || DiffOldPath != NULL ||
+                               Options.Stats != NULL)))
+    {
+        goto _usage;
+    }
+
+    if (DiffOldPath != NULL)
+    {
+        Ret = ENOMEM;
+        if (!SmbiosInitializeWriter(&Writer, stdout, 0))
+        {
+            puts("Initialize output writer failed");
+            return Ret;
+        }
+        if (!SmbiosCompileDecodePlans(&Plans))
+        {
+            SmbiosWriteString(&Writer, "Compile decode plans failed\n");
+        } else
+        {
+            Ret = DiffDumpFiles(DiffOldPath, DiffNewPath, &Plans, &Writer) ? 0 : ENODATA;
+            SmbiosFreeDecodePlans(&Plans);
+        }
+        SmbiosUninitializeWriter(&Writer);
+        return Ret;
+    }
+
+    if (StreamPath != NULL)
+    {
+        if (strcmp(StreamPath, "-") == 0)
+        {
+#ifdef _WIN32
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            Stream = stdin;
+        } else
+        {
+            Stream = fopen(StreamPath, "rb");
+        }
+        if (Stream == NULL)
+        {
+            puts("Open SMBIOS table stream failed");
+            return ENODATA;
+        }
+        Ret = ENOMEM;
+        if (!SmbiosInitializeWriter(&Writer, stdout, 0))
+        {
+            puts("Initialize output writer failed");
+        } else
+        {
+            Writer.Stats = Options.Stats;
+            if (!CompileDecodeOptions(&Options, &Plans, &Query))
             {
-                WORD j;
-                for (j = 0; j < TypeInfo->Fields[i].AdditionalInfo.Enum.Count; j++)
-                {
-                    if (TypeInfo->Fields[i].AdditionalInfo.Enum.Values[j].Value == Value)
-                    {
-                        printf(" (%s)", (const char*)TypeInfo->Fields[i].AdditionalInfo.Enum.Values[j].Name);
-                        break;
-                    }
-                }
+                SmbiosWriteString(&Writer, "Compile decode plans failed\n");
+            } else
+            {
+                Ret = DecodeStream(Stream, &Options, &Writer) ? 0 : EIO;
+                SmbiosFreeQuery(&Query);
+                SmbiosFreeDecodePlans(&Plans);
             }
-        } else if (TypeInfo->Fields[i].Type == SmbiosDataTypeRaw || TypeInfo->Fields[i].Type == SmbiosDataTypeOther)
-        {
-            BYTE j, *p;
-            p = (BYTE*)AddPtr(Table, TypeInfo->Fields[i].Offset);
-            for (j = 0; j < TypeInfo->Fields[i].Size; j++)
+            SmbiosUninitializeWriter(&Writer);
+            if (Options.Stats != NULL)
             {
-                printf("%02X", p[j]);
-                if (j != TypeInfo->Fields[i].Size - 1)
-                {
-                    putchar(' ');
-                }
+                PrintStats(Options.Stats);
             }
-        } else if (TypeInfo->Fields[i].Type == SmbiosDataTypeUuid && TypeInfo->Fields[i].Size == 16)
+        }
+        if (Stream != stdin)
         {
-            BYTE* Uuid = (BYTE*)AddPtr(Table, TypeInfo->Fields[i].Offset);
-            printf("%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-                   Uuid[0], Uuid[1], Uuid[2], Uuid[3], Uuid[4], Uuid[5], Uuid[6], Uuid[7],
-                   Uuid[8], Uuid[9], Uuid[10], Uuid[11], Uuid[12], Uuid[13], Uuid[14], Uuid[15]);
+            fclose(Stream);
         }
-        putchar('\n');
+        return Ret;
     }
 
-_Exit:
-    putchar('\n');
-    return NextTable;
-}
-
-int
-main()
-{
-    PSMBIOS_RAW_DATA Data;
-    PSMBIOS_TABLE Table;
+    if (BatchMode)
+    {
+        Ret = ENOMEM;
+        if (!CompileDecodeOptions(&Options, &Plans, &Query))
+        {
+            puts("Compile decode plans failed");
+            goto _exit_batch;
+        }
+        Batch.Output = stdout;
+        Batch.OutputExtension = Options.Json ? ".json" : ".txt";
+        Batch.Routine = DecodeDumpFile;
+        Batch.UserData = &Options;
+        Ret = SmbiosRunBatch(&Batch) ? 0 : ENODATA;
+        SmbiosFreeQuery(&Query);
+        SmbiosFreeDecodePlans(&Plans);
+        goto _exit_batch;
+    }
 
-#ifdef _WIN32
-    SetConsoleOutputCP(CP_UTF8);
-#endif
-    setlocale(LC_ALL, ".UTF-8");
+    /* Same boot needs no table read */
+    if (CachePath != NULL)
+    {
+        GetCacheKey(argc, argv, &CacheKey);
+        if (PrintCachedOutput(CachePath, &CacheKey))
+        {
+            return 0;
+        }
+    }
 
-    if (!GetSmbiosTableData(&Data))
+    SmbiosStartStage(&Timer, Options.Stats);
+    if (CorpusSpec != NULL)
+    {
+        SmbiosInitializeCorpusOptions(&CorpusOptions);
+        if (strcmp(CorpusSpec, "default") != 0 && !SmbiosParseCorpusOptions(CorpusSpec, &CorpusOptions))
+        {
+            printf("Invalid table generation options: %s\n", CorpusSpec);
+            return EINVAL;
+        }
+        Mapped = SmbiosGenerateTable(&CorpusOptions, &Data);
+        if (Mapped)
+        {
+            AttachSmbiosTableData(Data, &View);
+        }
+    } else if (ImagePath != NULL)
+    {
+        Mapped = MapSmbiosTableImage(ImagePath, ImageBase, &View);
+    } else if (FromDumpPath == NULL)
+    {
+        /* Query by types reads only structures of them if the system can, a dump or fingerprint needs all */
+        if (DumpPath == NULL && !Fingerprint && SmbiosGetQueryTypes(&Query, Types))
+        {
+            Mapped = MapSmbiosTableTypes(Types, &View);
+        } else
+        {
+            Mapped = MapSmbiosTableData(&View);
+        }
+    } else if (EntryPointPath == NULL)
+    {
+        Mapped = MapSmbiosTableDump(FromDumpPath, &View);
+    } else
+    {
+        Mapped = MapSmbiosTableFile(FromDumpPath, EntryPointPath, &View);
+    }
+    if (!Mapped)
     {
         puts("Get SMBIOS table failed");
         return ENODATA;
     }
-    printf("SMBIOS Version: %hhu.%hhu\n", Data->SMBIOSMajorVersion, Data->SMBIOSMinorVersion);
-    printf("DMI Revision: %hhu\n", Data->DmiRevision);
-    printf("Data Size: %lu bytes\n\n", Data->Length);
-    Table = (PSMBIOS_TABLE)Data->SMBIOSTableData;
-    do
+    SmbiosEndStage(&Timer, SmbiosStageLoad);
+    Stats.BytesRead = View.Length;
+    if (CachePath != NULL)
+    {
+        CacheKey.TableHash = SmbiosHashTable(View.SMBIOSTableData, View.Length);
+        if (PrintCachedOutput(CachePath, &CacheKey))
+        {
+            Ret = 0;
+            goto _exit_0;
+        }
+    }
+
+    /* Output to cache is kept in memory */
+    Ret = ENOMEM;
+    if (!SmbiosInitializeWriter(&Writer, CachePath != NULL ? NULL : stdout, 0))
+    {
+        puts("Initialize output writer failed");
+        goto _exit_0;
+    }
+    Writer.Stats = Options.Stats;
+    if (Fingerprint)
+    {
+        Ret = PrintFingerprint(&View, &Writer) ? 0 : ENOMEM;
+    } else if (DumpPath != NULL)
+    {
+        PrintTableHeader(&View, &Writer);
+        SmbiosFlushWriter(&Writer);
+        if (!SaveSmbiosTableDump(DumpPath, &View))
+        {
+            puts("Write dump file failed");
+            Ret = EIO;
+        } else
+        {
+            printf("Dumped to %s\n", DumpPath);
+            Ret = 0;
+        }
+    } else if (!CompileDecodeOptions(&Options, &Plans, &Query))
+    {
+        puts("Compile decode plans failed");
+    } else
+    {
+        Ret = DecodeTable(&View, &Options, &Writer) ? 0 : ENOMEM;
+        SmbiosFreeQuery(&Query);
+        SmbiosFreeDecodePlans(&Plans);
+    }
+    if (CachePath != NULL)
+    {
+        fwrite(Writer.Buffer, 1, Writer.Used, stdout);
+        if (Ret == 0 && !Writer.Failed && !SmbiosSaveCache(CachePath, &CacheKey, Writer.Buffer, Writer.Used))
+        {
+            fputs("Write cache failed\n", stderr);
+        }
+    }
+    SmbiosUninitializeWriter(&Writer);
+    if (Options.Stats != NULL)
     {
-        Table = PrintSmbiosTable(Table, Data->SMBIOSTableData, AddPtr(Data->SMBIOSTableData, Data->Length));
-    } while (Table != NULL);
-    free(Data);
-    return 0;
+        PrintStats(Options.Stats);
+    }
+
+_exit_0:
+    UnmapSmbiosTableData(&View);
+    return Ret;
+
+_usage:
+    PrintUsage();
+_exit_batch:
+    SmbiosFreeBatch(&Batch);
+    return Ret;
 }
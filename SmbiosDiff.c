@@ -0,0 +1,304 @@
+﻿#include "SmbiosDiff.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define DIFF_UNPAIRED ((DWORD)-1)
+
+/* Pair structures of the same handle and type, duplicated handles are paired in table order */
+static
+void
+PairByHandle(
+    const SMBIOS_TABLE_INDEX* Old,
+    const SMBIOS_TABLE_INDEX* New,
+    DWORD* OldPairs,
+    DWORD* NewPairs)
+{
+    const SMBIOS_INDEX_HANDLE* o;
+    const SMBIOS_INDEX_HANDLE* n;
+    DWORD i = 0, j = 0;
+
+    while (i < Old->Count && j < New->Count)
+    {
+        o = &Old->Handles[i];
+        n = &New->Handles[j];
+        if (o->Handle < n->Handle)
+        {
+            i++;
+        } else if (n->Handle < o->Handle)
+        {
+            j++;
+        } else
+        {
+            if (Old->Entries[o->Entry].Type == New->Entries[n->Entry].Type)
+            {
+                OldPairs[o->Entry] = n->Entry;
+                NewPairs[n->Entry] = o->Entry;
+            }
+            i++;
+            j++;
+        }
+    }
+}
+
+/* Pair the rest by instance order of each type, e.g. a memory device whose handle was renumbered */
+static
+void
+PairByType(
+    const SMBIOS_TABLE_INDEX* Old,
+    const SMBIOS_TABLE_INDEX* New,
+    DWORD* OldPairs,
+    DWORD* NewPairs)
+{
+    DWORD Type, i, j, OldEnd, NewEnd;
+
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        i = Old->TypeStart[Type];
+        j = New->TypeStart[Type];
+        OldEnd = Old->TypeStart[Type + 1];
+        NewEnd = New->TypeStart[Type + 1];
+        for (;;)
+        {
+            while (i < OldEnd && OldPairs[Old->ByType[i]] != DIFF_UNPAIRED)
+            {
+                i++;
+            }
+            while (j < NewEnd && NewPairs[New->ByType[j]] != DIFF_UNPAIRED)
+            {
+                j++;
+            }
+            if (i == OldEnd || j == NewEnd)
+            {
+                break;
+            }
+            OldPairs[Old->ByType[i]] = New->ByType[j];
+            NewPairs[New->ByType[j]] = Old->ByType[i];
+        }
+    }
+}
+
+/* Header fields other than handle, then the rest of formatted area and string-set */
+static
+bool
+IsSameStructure(
+    const SMBIOS_TABLE_INDEX* Old,
+    const SMBIOS_INDEX_ENTRY* OldEntry,
+    const SMBIOS_TABLE_INDEX* New,
+    const SMBIOS_INDEX_ENTRY* NewEntry)
+{
+    const BYTE* OldData = (const BYTE*)SmbiosIndexGetTable(Old, OldEntry);
+    const BYTE* NewData = (const BYTE*)SmbiosIndexGetTable(New, NewEntry);
+
+    return OldEntry->Handle == NewEntry->Handle &&
+           OldEntry->Size == NewEntry->Size &&
+           OldEntry->Length == NewEntry->Length &&
+           memcmp(OldData, NewData, offsetof(SMBIOS_HEADER, Handle)) == 0 &&
+           memcmp(OldData + sizeof(SMBIOS_HEADER),
+                  NewData + sizeof(SMBIOS_HEADER),
+                  OldEntry->Size - sizeof(SMBIOS_HEADER)) == 0;
+}
+
+/* Context of an indexed structure alone, as the stream decoder makes them, nothing is allocated */
+static
+bool
+InitializeStructureContext(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_TABLE_INDEX* Index,
+    const SMBIOS_INDEX_ENTRY* Entry,
+    const SMBIOS_DECODE_PLANS* Plans)
+{
+    SmbiosInitializeStructureContext(Context, SmbiosIndexGetTable(Index, Entry), Entry->Size, Plans);
+    if (!SmbiosNextStructure(Context))
+    {
+        return false;
+    }
+    Context->Offset = Entry->Offset;
+    return true;
+}
+
+static
+bool
+IsSameValue(
+    const SMBIOS_DECODE_STEP* Step,
+    const SMBIOS_FIELD_VALUE* Old,
+    const SMBIOS_FIELD_VALUE* New)
+{
+    if (Step->Flags & SMBIOS_DECODE_STEP_STRING)
+    {
+        if (Old->String == NULL || New->String == NULL)
+        {
+            return Old->String == New->String;
+        }
+        return strcmp(Old->String, New->String) == 0;
+    }
+    if (Step->Mask != 0)
+    {
+        return Old->Value == New->Value;
+    }
+    return memcmp(Old->Data, New->Data, Step->DataSize) == 0;
+}
+
+/* Both structures are of the same type so share the plan, a longer one has more steps to run */
+static
+SMBIOS_VISIT_ACTION
+DiffFields(
+    const SMBIOS_DECODE_CONTEXT* Old,
+    const SMBIOS_DECODE_CONTEXT* New,
+    const SMBIOS_DIFF_VISITOR* Visitor)
+{
+    const SMBIOS_DECODE_PLAN* Plan = Old->Plan;
+    const SMBIOS_DECODE_STEP* Step;
+    SMBIOS_FIELD_VALUE OldValue, NewValue;
+    SMBIOS_VISIT_ACTION Action;
+    QWORD OldInteger = 0, NewInteger = 0;
+    WORD OldCount, NewCount, i;
+
+    if (Plan == NULL || Visitor->OnField == NULL)
+    {
+        return SmbiosVisitContinue;
+    }
+    OldCount = SmbiosDecodePlanStepCount(Plan, Old->Length);
+    NewCount = SmbiosDecodePlanStepCount(Plan, New->Length);
+    for (i = 0; i < OldCount || i < NewCount; i++)
+    {
+        Step = &Plan->Steps[i];
+        if (i < OldCount)
+        {
+            SmbiosLoadStepValue(Old, Step, &OldInteger, &OldValue);
+        }
+        if (i < NewCount)
+        {
+            SmbiosLoadStepValue(New, Step, &NewInteger, &NewValue);
+        }
+        if (i < OldCount && i < NewCount && IsSameValue(Step, &OldValue, &NewValue))
+        {
+            continue;
+        }
+        Action = Visitor->OnField(Visitor->UserData,
+                                  (SMBIOS_DECODE_STEP_KIND)Step->Kind,
+                                  Old,
+                                  i < OldCount ? &OldValue : NULL,
+                                  New,
+                                  i < NewCount ? &NewValue : NULL);
+        if (Action != SmbiosVisitContinue)
+        {
+            return Action;
+        }
+    }
+    return SmbiosVisitContinue;
+}
+
+/* Report one structure, either entry could be NULL */
+static
+bool
+DiffStructure(
+    SMBIOS_FINGERPRINT_CHANGE Change,
+    const SMBIOS_TABLE_INDEX* Old,
+    const SMBIOS_INDEX_ENTRY* OldEntry,
+    const SMBIOS_TABLE_INDEX* New,
+    const SMBIOS_INDEX_ENTRY* NewEntry,
+    const SMBIOS_DECODE_PLANS* Plans,
+    const SMBIOS_DIFF_VISITOR* Visitor,
+    SMBIOS_VISIT_ACTION* Action)
+{
+    SMBIOS_DECODE_CONTEXT OldContext, NewContext;
+    PSMBIOS_DECODE_CONTEXT OldPointer = NULL, NewPointer = NULL;
+
+    *Action = SmbiosVisitContinue;
+    if (OldEntry != NULL)
+    {
+        if (!InitializeStructureContext(&OldContext, Old, OldEntry, Plans))
+        {
+            return false;
+        }
+        OldPointer = &OldContext;
+    }
+    if (NewEntry != NULL)
+    {
+        if (!InitializeStructureContext(&NewContext, New, NewEntry, Plans))
+        {
+            return false;
+        }
+        NewPointer = &NewContext;
+    }
+
+    /* Skip from any callback only ends this structure */
+    *Action = Visitor->OnStructure != NULL ? Visitor->OnStructure(Visitor->UserData, Change, OldPointer, NewPointer) : SmbiosVisitContinue;
+    if (*Action == SmbiosVisitContinue)
+    {
+        if (Change == SmbiosStructureChanged)
+        {
+            *Action = DiffFields(OldPointer, NewPointer, Visitor);
+        }
+        if (*Action != SmbiosVisitStop && Visitor->OnStructureEnd != NULL)
+        {
+            *Action = Visitor->OnStructureEnd(Visitor->UserData, Change, OldPointer, NewPointer);
+        }
+    }
+    return true;
+}
+
+bool
+SmbiosDiffTables(
+    const void* OldTableData,
+    DWORD OldLength,
+    const void* NewTableData,
+    DWORD NewLength,
+    const SMBIOS_DECODE_PLANS* Plans,
+    const SMBIOS_DIFF_VISITOR* Visitor)
+{
+    SMBIOS_TABLE_INDEX Old, New;
+    SMBIOS_VISIT_ACTION Action = SmbiosVisitContinue;
+    DWORD* OldPairs = NULL;
+    DWORD* NewPairs = NULL;
+    DWORD i;
+    bool Result = false;
+
+    if (!SmbiosBuildIndex(OldTableData, OldLength, &Old))
+    {
+        return false;
+    }
+    if (!SmbiosBuildIndex(NewTableData, NewLength, &New))
+    {
+        SmbiosFreeIndex(&Old);
+        return false;
+    }
+    OldPairs = (DWORD*)malloc((Old.Count + 1) * sizeof(DWORD));
+    NewPairs = (DWORD*)malloc((New.Count + 1) * sizeof(DWORD));
+    if (OldPairs == NULL || NewPairs == NULL)
+    {
+        goto _exit;
+    }
+    memset(OldPairs, 0xFF, Old.Count * sizeof(DWORD));
+    memset(NewPairs, 0xFF, New.Count * sizeof(DWORD));
+
+    PairByHandle(&Old, &New, OldPairs, NewPairs);
+    PairByType(&Old, &New, OldPairs, NewPairs);
+
+    Result = true;
+    for (i = 0; i < Old.Count && Result && Action != SmbiosVisitStop; i++)
+    {
+        if (OldPairs[i] == DIFF_UNPAIRED)
+        {
+            Result = DiffStructure(SmbiosStructureRemoved, &Old, &Old.Entries[i], &New, NULL, Plans, Visitor, &Action);
+        } else if (!IsSameStructure(&Old, &Old.Entries[i], &New, &New.Entries[OldPairs[i]]))
+        {
+            Result = DiffStructure(SmbiosStructureChanged, &Old, &Old.Entries[i], &New, &New.Entries[OldPairs[i]], Plans, Visitor, &Action);
+        }
+    }
+    for (i = 0; i < New.Count && Result && Action != SmbiosVisitStop; i++)
+    {
+        if (NewPairs[i] == DIFF_UNPAIRED)
+        {
+            Result = DiffStructure(SmbiosStructureAdded, &Old, NULL, &New, &New.Entries[i], Plans, Visitor, &Action);
+        }
+    }
+
+_exit:
+    free(OldPairs);
+    free(NewPairs);
+    SmbiosFreeIndex(&Old);
+    SmbiosFreeIndex(&New);
+    return Result;
+}
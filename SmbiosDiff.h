@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "SmbiosFingerprint.h"
+#include "SmbiosVisit.h"
+
+/*
+ * Old is NULL for added structures, New is NULL for removed ones. Contexts hold the structure alone, at its offset
+ * in its table. Return SmbiosVisitSkip to skip fields of a changed structure, or SmbiosVisitStop to stop comparing.
+ */
+typedef
+SMBIOS_VISIT_ACTION
+(*SMBIOS_DIFF_STRUCTURE_ROUTINE)(
+    void* UserData,
+    SMBIOS_FINGERPRINT_CHANGE Change,
+    const SMBIOS_DECODE_CONTEXT* Old,
+    const SMBIOS_DECODE_CONTEXT* New);
+
+/* A field that differs, OldValue or NewValue is NULL if the structure is too short to have it */
+typedef
+SMBIOS_VISIT_ACTION
+(*SMBIOS_DIFF_FIELD_ROUTINE)(
+    void* UserData,
+    SMBIOS_DECODE_STEP_KIND Kind,
+    const SMBIOS_DECODE_CONTEXT* Old,
+    const SMBIOS_FIELD_VALUE* OldValue,
+    const SMBIOS_DECODE_CONTEXT* New,
+    const SMBIOS_FIELD_VALUE* NewValue);
+
+/*
+ * Callbacks of comparing two tables, any of them could be NULL.
+ *
+ * OnStructure: Each structure added, removed or changed.
+ * OnField: Each field that differs between a changed structure and its old one, in field order.
+ * OnStructureEnd: After fields of a structure, unless skipped by OnStructure.
+ */
+typedef struct _SMBIOS_DIFF_VISITOR
+{
+    void* UserData;
+    SMBIOS_DIFF_STRUCTURE_ROUTINE OnStructure;
+    SMBIOS_DIFF_FIELD_ROUTINE OnField;
+    SMBIOS_DIFF_STRUCTURE_ROUTINE OnStructureEnd;
+} SMBIOS_DIFF_VISITOR, *PSMBIOS_DIFF_VISITOR;
+
+/*
+ * Pair structures of two tables by handle and type, then the rest by type and instance order, and visit the
+ * differences: removed and changed structures in old table order, then added ones in new table order.
+ * A pair is changed if any byte other than the handle differs, or the handle does, then its fields are compared by
+ * value and strings by content, so a changed structure may have no field reported (e.g. strings reordered).
+ * Fields are only compared if Plans is not NULL. Takes time linear in the tables if handles are ascending, as
+ * firmware usually assigns them.
+ * Returns false if either table could not be indexed.
+ */
+bool
+SmbiosDiffTables(
+    const void* OldTableData,
+    DWORD OldLength,
+    const void* NewTableData,
+    DWORD NewLength,
+    const SMBIOS_DECODE_PLANS* Plans,
+    const SMBIOS_DIFF_VISITOR* Visitor);
@@ -0,0 +1,323 @@
+﻿#include "SmbiosFingerprint.h"
+#include "SmbiosContext.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FINGERPRINT_INITIAL_CAPACITY 64
+
+#pragma region XXH64
+
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define RotateLeft64(Value, Bits) (((Value) << (Bits)) | ((Value) >> (64 - (Bits))))
+
+static
+QWORD
+Read64(
+    const BYTE* Data)
+{
+    QWORD Value;
+
+    memcpy(&Value, Data, sizeof(Value));
+    return Value;
+}
+
+static
+DWORD
+Read32(
+    const BYTE* Data)
+{
+    DWORD Value;
+
+    memcpy(&Value, Data, sizeof(Value));
+    return Value;
+}
+
+static
+QWORD
+Round(
+    QWORD Accumulator,
+    QWORD Input)
+{
+    Accumulator += Input * XXH_PRIME64_2;
+    Accumulator = RotateLeft64(Accumulator, 31);
+    return Accumulator * XXH_PRIME64_1;
+}
+
+static
+QWORD
+MergeRound(
+    QWORD Accumulator,
+    QWORD Value)
+{
+    Accumulator ^= Round(0, Value);
+    return Accumulator * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+QWORD
+SmbiosHashData(
+    const void* Data,
+    size_t Size,
+    QWORD Seed)
+{
+    const BYTE* p = (const BYTE*)Data;
+    const BYTE* End = p + Size;
+    QWORD v1, v2, v3, v4, Hash;
+
+    if (Size >= 32)
+    {
+        v1 = Seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        v2 = Seed + XXH_PRIME64_2;
+        v3 = Seed;
+        v4 = Seed - XXH_PRIME64_1;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (End - p >= 32);
+        Hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) + RotateLeft64(v4, 18);
+        Hash = MergeRound(Hash, v1);
+        Hash = MergeRound(Hash, v2);
+        Hash = MergeRound(Hash, v3);
+        Hash = MergeRound(Hash, v4);
+    } else
+    {
+        Hash = Seed + XXH_PRIME64_5;
+    }
+    Hash += (QWORD)Size;
+
+    while (End - p >= 8)
+    {
+        Hash ^= Round(0, Read64(p));
+        Hash = RotateLeft64(Hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+    if (End - p >= 4)
+    {
+        Hash ^= (QWORD)Read32(p) * XXH_PRIME64_1;
+        Hash = RotateLeft64(Hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    while (p < End)
+    {
+        Hash ^= *p * XXH_PRIME64_5;
+        Hash = RotateLeft64(Hash, 11) * XXH_PRIME64_1;
+        p++;
+    }
+
+    Hash ^= Hash >> 33;
+    Hash *= XXH_PRIME64_2;
+    Hash ^= Hash >> 29;
+    Hash *= XXH_PRIME64_3;
+    Hash ^= Hash >> 32;
+    return Hash;
+}
+
+#pragma endregion
+
+#pragma region Volatile Fields
+
+typedef struct _VOLATILE_FIELD
+{
+    BYTE Type;
+    BYTE Offset;
+    BYTE Size;                      // 0 for up to the end of formatted area
+} VOLATILE_FIELD, *PVOLATILE_FIELD;
+
+#define DEFINE_VOLATILE_FIELD(Type, Struct, Member) { Type, (BYTE)offsetof(Struct, Member), (BYTE)sizeof(((Struct*)0)->Member) }
+#define DEFINE_VOLATILE_TAIL(Type, Struct, Member) { Type, (BYTE)offsetof(Struct, Member), 0 }
+
+/* Fields firmware may rewrite on every boot or at run time, while the hardware described stays the same */
+static const VOLATILE_FIELD VolatileFields[] = {
+    DEFINE_VOLATILE_FIELD(4, SMBIOS_PROCESSOR_INFORMATION, CurrentSpeed),
+    DEFINE_VOLATILE_FIELD(9, SMBIOS_SYSTEM_SLOTS, CurrentUsage),
+    DEFINE_VOLATILE_FIELD(15, SMBIOS_SYSTEM_EVENT_LOG, Status),
+    DEFINE_VOLATILE_FIELD(15, SMBIOS_SYSTEM_EVENT_LOG, ChangeToken),
+    DEFINE_VOLATILE_TAIL(32, SMBIOS_SYSTEM_BOOT_INFORMATION, Status),
+    DEFINE_VOLATILE_FIELD(39, SMBIOS_SYSTEM_POWER_SUPPLY, Characteristics),
+};
+
+/* Formatted area of Length bytes with volatile fields zeroed, or as is if its type has none */
+static
+QWORD
+HashFormattedArea(
+    const BYTE* Data,
+    BYTE Length)
+{
+    BYTE Buffer[UCHAR_MAX];
+    BYTE Type = Data[0];
+    size_t i;
+    bool Copied = false;
+
+    for (i = 0; i < sizeof(VolatileFields) / sizeof(VolatileFields[0]); i++)
+    {
+        if (VolatileFields[i].Type != Type || VolatileFields[i].Offset >= Length)
+        {
+            continue;
+        }
+        if (!Copied)
+        {
+            memcpy(Buffer, Data, Length);
+            Copied = true;
+        }
+        memset(Buffer + VolatileFields[i].Offset,
+               0,
+               VolatileFields[i].Size != 0 && VolatileFields[i].Offset + VolatileFields[i].Size <= Length ?
+                   VolatileFields[i].Size :
+                   Length - VolatileFields[i].Offset);
+    }
+    return SmbiosHashData(Copied ? Buffer : Data, Length, 0);
+}
+
+#pragma endregion
+
+QWORD
+SmbiosHashTable(
+    const void* TableData,
+    DWORD Length)
+{
+    return SmbiosHashData(TableData, Length, 0);
+}
+
+static
+int
+CompareStructureFingerprint(
+    const void* A,
+    const void* B)
+{
+    const SMBIOS_STRUCTURE_FINGERPRINT* p = (const SMBIOS_STRUCTURE_FINGERPRINT*)A;
+    const SMBIOS_STRUCTURE_FINGERPRINT* q = (const SMBIOS_STRUCTURE_FINGERPRINT*)B;
+
+    if (p->Handle != q->Handle)
+    {
+        return p->Handle < q->Handle ? -1 : 1;
+    }
+    return p->Offset < q->Offset ? -1 : (p->Offset > q->Offset ? 1 : 0);
+}
+
+/* Grow structure array by double */
+static
+bool
+GrowFingerprint(
+    PSMBIOS_FINGERPRINT Fingerprint,
+    DWORD* Capacity)
+{
+    PSMBIOS_STRUCTURE_FINGERPRINT Structures;
+    DWORD NewCapacity;
+
+    NewCapacity = *Capacity != 0 ? *Capacity * 2 : FINGERPRINT_INITIAL_CAPACITY;
+    Structures = (PSMBIOS_STRUCTURE_FINGERPRINT)realloc(Fingerprint->Structures, NewCapacity * sizeof(SMBIOS_STRUCTURE_FINGERPRINT));
+    if (Structures == NULL)
+    {
+        return false;
+    }
+    Fingerprint->Structures = Structures;
+    *Capacity = NewCapacity;
+    return true;
+}
+
+bool
+SmbiosFingerprintTable(
+    const void* TableData,
+    DWORD Length,
+    PSMBIOS_FINGERPRINT Fingerprint)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+    PSMBIOS_STRUCTURE_FINGERPRINT Structure;
+    const BYTE* Data;
+    DWORD Capacity = 0;
+    bool Sorted = true;
+
+    memset(Fingerprint, 0, sizeof(*Fingerprint));
+    Fingerprint->TableHash = SmbiosHashTable(TableData, Length);
+    if (!SmbiosInitializeContext(&Context, TableData, Length, NULL))
+    {
+        return false;
+    }
+
+    /* Hash in table order for the stable hash, then sort by handle */
+    while (SmbiosNextStructure(&Context))
+    {
+        if (Fingerprint->Count == Capacity && !GrowFingerprint(Fingerprint, &Capacity))
+        {
+            SmbiosUninitializeContext(&Context);
+            SmbiosFreeFingerprint(Fingerprint);
+            return false;
+        }
+        Structure = &Fingerprint->Structures[Fingerprint->Count];
+        Data = (const BYTE*)Context.Table;
+        Structure->Hash = SmbiosHashData(Data + Context.Length, Context.Size - Context.Length, HashFormattedArea(Data, Context.Length));
+        Structure->Offset = Context.Offset;
+        Structure->Handle = Context.Table->Header.Handle;
+        Structure->Type = Context.Table->Header.Type;
+        Fingerprint->StableHash = SmbiosHashData(&Structure->Hash, sizeof(Structure->Hash), Fingerprint->StableHash);
+        if (Fingerprint->Count != 0 && Structure->Handle < Structure[-1].Handle)
+        {
+            Sorted = false;
+        }
+        Fingerprint->Count++;
+    }
+    SmbiosUninitializeContext(&Context);
+
+    /* Handles are usually assigned in ascending order by firmware */
+    if (!Sorted)
+    {
+        qsort(Fingerprint->Structures, Fingerprint->Count, sizeof(SMBIOS_STRUCTURE_FINGERPRINT), CompareStructureFingerprint);
+    }
+    return true;
+}
+
+void
+SmbiosFreeFingerprint(
+    PSMBIOS_FINGERPRINT Fingerprint)
+{
+    free(Fingerprint->Structures);
+    memset(Fingerprint, 0, sizeof(*Fingerprint));
+}
+
+DWORD
+SmbiosCompareFingerprints(
+    const SMBIOS_FINGERPRINT* Old,
+    const SMBIOS_FINGERPRINT* New,
+    SMBIOS_FINGERPRINT_ROUTINE Routine,
+    void* UserData)
+{
+    const SMBIOS_STRUCTURE_FINGERPRINT* o;
+    const SMBIOS_STRUCTURE_FINGERPRINT* n;
+    DWORD i = 0, j = 0, Changes = 0;
+    bool Continue = true;
+
+    while (Continue && (i < Old->Count || j < New->Count))
+    {
+        o = i < Old->Count ? &Old->Structures[i] : NULL;
+        n = j < New->Count ? &New->Structures[j] : NULL;
+        if (n == NULL || (o != NULL && o->Handle < n->Handle))
+        {
+            Continue = Routine(UserData, SmbiosStructureRemoved, o, NULL);
+            i++;
+        } else if (o == NULL || n->Handle < o->Handle)
+        {
+            Continue = Routine(UserData, SmbiosStructureAdded, NULL, n);
+            j++;
+        } else
+        {
+            i++;
+            j++;
+            if (o->Hash == n->Hash && o->Type == n->Type)
+            {
+                continue;
+            }
+            Continue = Routine(UserData, SmbiosStructureChanged, o, n);
+        }
+        Changes++;
+    }
+    return Changes;
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Hash of a structure, fields that change without the hardware changing (e.g. event log change token) are zeroed */
+typedef struct _SMBIOS_STRUCTURE_FINGERPRINT
+{
+    QWORD Hash;                     // Formatted area and string-set
+    DWORD Offset;                   // Offset of structure in table data
+    WORD Handle;
+    BYTE Type;
+} SMBIOS_STRUCTURE_FINGERPRINT, *PSMBIOS_STRUCTURE_FINGERPRINT;
+
+/*
+ * Fingerprint of a table to tell whether it changed since last read without decoding it, and which structures
+ * changed if it did.
+ */
+typedef struct _SMBIOS_FINGERPRINT
+{
+    QWORD TableHash;                // All bytes of table, same as SmbiosHashTable
+    QWORD StableHash;               // Structure hashes in table order, not changed by volatile fields
+    PSMBIOS_STRUCTURE_FINGERPRINT Structures; // Sorted by handle, same handles in table order // _Field_size_(Count)
+    DWORD Count;
+} SMBIOS_FINGERPRINT, *PSMBIOS_FINGERPRINT;
+
+typedef enum _SMBIOS_FINGERPRINT_CHANGE
+{
+    SmbiosStructureAdded,
+    SmbiosStructureRemoved,
+    SmbiosStructureChanged
+} SMBIOS_FINGERPRINT_CHANGE, *PSMBIOS_FINGERPRINT_CHANGE;
+
+/* Old is NULL for added structures, New is NULL for removed ones, return false to stop comparing */
+typedef
+bool
+(*SMBIOS_FINGERPRINT_ROUTINE)(
+    void* UserData,
+    SMBIOS_FINGERPRINT_CHANGE Change,
+    const SMBIOS_STRUCTURE_FINGERPRINT* Old,
+    const SMBIOS_STRUCTURE_FINGERPRINT* New);
+
+/* 64-bit non-cryptographic hash (XXH64), for change detection only */
+QWORD
+SmbiosHashData(
+    const void* Data,
+    size_t Size,
+    QWORD Seed);
+
+/* Hash of all bytes of a table, without walking it or allocating */
+QWORD
+SmbiosHashTable(
+    const void* TableData,
+    DWORD Length);
+
+/* Walk the table once and hash each structure, free with SmbiosFreeFingerprint */
+bool
+SmbiosFingerprintTable(
+    const void* TableData,
+    DWORD Length,
+    PSMBIOS_FINGERPRINT Fingerprint);
+
+void
+SmbiosFreeFingerprint(
+    PSMBIOS_FINGERPRINT Fingerprint);
+
+/*
+ * Pair structures of two fingerprints by handle in one pass and call Routine on each one added, removed or
+ * changed, returns number of changes reported. Structures with the same handle are paired in table order.
+ */
+DWORD
+SmbiosCompareFingerprints(
+    const SMBIOS_FINGERPRINT* Old,
+    const SMBIOS_FINGERPRINT* New,
+    SMBIOS_FINGERPRINT_ROUTINE Routine,
+    void* UserData);
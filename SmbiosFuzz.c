@@ -0,0 +1,474 @@
+﻿/*
+ * Fuzz target of walking and decoding a bare table (e.g. /sys/firmware/dmi/tables/DMI) from an untrusted source.
+ *
+ *   libFuzzer: clang -g -O1 -fsanitize=fuzzer,address,undefined -D_LINUX -DSMBIOS_FUZZ_LIBFUZZER SmbiosFuzz.c <library> -pthread
+ *   AFL:       afl-clang-fast -g -D_LINUX SmbiosFuzz.c <library> -pthread, then afl-fuzz -i SEEDS -o OUT -- ./SmbiosFuzz @@
+ *   Replay:    any build without SMBIOS_FUZZ_LIBFUZZER, SmbiosFuzz FILE... (standard input without files)
+ *   Corpus:    FuzzCorpus is replayed by CI, the seeds and fuzzing finds minimized with libFuzzer, to refresh it:
+ *              SmbiosFuzz -merge=1 NEW_DIR FuzzCorpus SEED_DIR FINDINGS_DIR, then replace FuzzCorpus with NEW_DIR
+ *   Seeds:     SmbiosFuzz --seed-corpus DIR writes synthetic tables with each defect SmbiosCorpus.h can make
+ *
+ * <library> is SmbiosContext.c SmbiosCorpus.c SmbiosJson.c SmbiosPlan.c SmbiosScan.c SmbiosStats.c SmbiosStream.c
+ * SmbiosTable.c SmbiosText.c SmbiosVisit.c SmbiosWriter.c. Besides what sanitizers catch, each input aborts if:
+ *   - String-set walk, decode context, table index and stream parser (in chunks of any size) split it differently
+ *   - A string the decoder resolves is not terminated inside its structure
+ *   - Structures or visited fields are more than a constant times the input size
+ *   - Output bytes are more than the fields visited print at most, escaped, so output is linear in structures decoded
+ *   - Processor time is more than FUZZ_TIME_BASE plus the input size at FUZZ_BYTES_PER_SECOND, so walking, scanning
+ *     and indexing stay linear
+ */
+
+#include "SMBIOS.h"
+#include "SMBIOS.TypeInfo.h"
+#include "SmbiosContext.h"
+#include "SmbiosCorpus.h"
+#include "SmbiosJson.h"
+#include "SmbiosStream.h"
+#include "SmbiosText.h"
+#include "SmbiosVisit.h"
+#include "SmbiosWriter.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+/* Bounds of output, by what each structure and field prints */
+#define FUZZ_STRUCTURE_OUTPUT 256   // Header of a structure
+#define FUZZ_FIELD_OUTPUT 128       // Field without its name, enumeration name, string and data bytes
+#define FUZZ_BYTE_OUTPUT 3          // Data byte printed as "XX "
+#define FUZZ_ESCAPE_RATIO 6         // JSON escapes a byte to at most "\u00XX"
+
+/* Bounds of processor time, a tenth of the throughput of a sanitized -O1 build */
+#define FUZZ_TIME_BASE 1.0          // Seconds of any input
+#define FUZZ_BYTES_PER_SECOND 0x40000
+
+static const char* const SeedTables[] = {
+    "default",
+    "all-types",
+    "all-types,truncate,version=2.4",
+    "strings=4,strlen=32",
+    "defect=zero-length",
+    "defect=length-past-end",
+    "defect=unterminated-strings",
+    "defect=bad-string-index",
+    "defect=duplicate-handle",
+    "defect=no-end",
+    "defect=truncated",
+    "all-types,defect=truncated,seed=2",
+};
+
+typedef struct _FUZZ_STRUCTURE
+{
+    DWORD Offset;
+    DWORD Size;
+} FUZZ_STRUCTURE, *PFUZZ_STRUCTURE;
+
+/* Structures split by the string-set walk, as reference for other walkers */
+typedef struct _FUZZ_WALK
+{
+    PFUZZ_STRUCTURE Structures;     // _Field_size_(Count)
+    size_t Count;
+    size_t Streamed;                // Structures the stream parser matched so far
+    bool Mismatch;
+} FUZZ_WALK, *PFUZZ_WALK;
+
+/* Fields visited with interpreted plans, and output printers may write for them */
+typedef struct _FUZZ_DECODE_COUNT
+{
+    size_t Fields;
+    size_t Output;
+} FUZZ_DECODE_COUNT, *PFUZZ_DECODE_COUNT;
+
+static SMBIOS_DECODE_PLANS Plans;
+static SMBIOS_DECODE_PLANS InterpretPlans;
+static size_t MaxStepCount;
+
+static
+void
+Check(
+    bool Condition,
+    const char* Message)
+{
+    if (!Condition)
+    {
+        printf("Fuzz check failed: %s\n", Message);
+        fflush(stdout);
+        abort();
+    }
+}
+
+static
+void
+Initialize(void)
+{
+    static bool Initialized = false;
+    unsigned int Type;
+
+    if (Initialized)
+    {
+        return;
+    }
+    Check(SmbiosCompileDecodePlans(&Plans) && SmbiosCompileDecodePlans(&InterpretPlans), "compile decode plans");
+    InterpretPlans.InterpretOnly = true;
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        if (SmbiosTypeInfoByType[Type] != NULL && Plans.ByType[Type].StepCount > MaxStepCount)
+        {
+            MaxStepCount = Plans.ByType[Type].StepCount;
+        }
+    }
+    Initialized = true;
+}
+
+static
+void
+WalkTable(
+    const BYTE* Data,
+    DWORD Size,
+    PFUZZ_WALK Walk)
+{
+    PSMBIOS_TABLE Table, NextTable;
+    const void* EndOfData;
+    BYTE StringCount;
+
+    /* A structure takes at least a header, so the count is known */
+    Walk->Structures = (PFUZZ_STRUCTURE)malloc((Size / sizeof(SMBIOS_HEADER) + 1) * sizeof(FUZZ_STRUCTURE));
+    Check(Walk->Structures != NULL, "allocate walk");
+    Walk->Count = 0;
+    EndOfData = Data + Size;
+    Table = (PSMBIOS_TABLE)Data;
+    while (Table != NULL &&
+           SubPtr(Table, EndOfData) >= sizeof(SMBIOS_HEADER) &&
+           Table->Header.Length >= sizeof(SMBIOS_HEADER))
+    {
+        NextTable = SmbiosWalkStructure(Table, EndOfData, NULL, &StringCount);
+        Check(NextTable == NULL || ((const BYTE*)NextTable > (const BYTE*)Table && (const BYTE*)NextTable < (const BYTE*)EndOfData),
+              "walk moves forward within data");
+        Check(Walk->Count <= Size / sizeof(SMBIOS_HEADER), "structures within input size");
+        Walk->Structures[Walk->Count].Offset = SubPtr(Data, Table);
+        Walk->Structures[Walk->Count].Size = SubPtr(Table, NextTable == NULL ? EndOfData : (const void*)NextTable);
+        Walk->Count++;
+        Table = NextTable;
+    }
+}
+
+static
+void
+CheckContext(
+    const BYTE* Data,
+    DWORD Size,
+    const FUZZ_WALK* Walk)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+    const char* String;
+    size_t Count = 0;
+    BYTE i;
+
+    Check(SmbiosInitializeContext(&Context, Data, Size, NULL), "initialize context");
+    while (SmbiosNextStructure(&Context))
+    {
+        Check(Count < Walk->Count, "context has no more structures than walk");
+        Check(Context.Offset == Walk->Structures[Count].Offset && Context.Size == Walk->Structures[Count].Size,
+              "context splits structures as walk");
+        Check(Context.Length >= sizeof(SMBIOS_HEADER) && Context.Length <= Context.Size, "decoded length within structure");
+
+        /* Printers take strings as NUL terminated */
+        for (i = 0; i < Context.StringCount; i++)
+        {
+            String = Context.Strings[i];
+            Check(String >= (const char*)Context.Table + Context.Length &&
+                  String < (const char*)Context.Table + Context.Size,
+                  "string within string-set");
+            Check(memchr(String, '\0', (const char*)Context.Table + Context.Size - String) != NULL,
+                  "string terminated within structure");
+        }
+        Count++;
+    }
+    Check(Count == Walk->Count, "context has as many structures as walk");
+    SmbiosUninitializeContext(&Context);
+}
+
+static
+void
+CheckIndex(
+    const BYTE* Data,
+    DWORD Size,
+    const FUZZ_WALK* Walk)
+{
+    SMBIOS_TABLE_INDEX Index;
+    DWORD i;
+
+    Check(SmbiosBuildIndex(Data, Size, &Index), "build index");
+    Check(Index.Count == Walk->Count, "index has as many structures as walk");
+    for (i = 0; i < Index.Count; i++)
+    {
+        Check(Index.Entries[i].Offset == Walk->Structures[i].Offset && Index.Entries[i].Size == Walk->Structures[i].Size,
+              "index splits structures as walk");
+        Check(Index.Entries[i].Length <= Index.Entries[i].Size, "index length within structure");
+        Check(SmbiosIndexFindHandle(&Index, Index.Entries[i].Handle) != NULL, "index finds every handle");
+    }
+    SmbiosFreeIndex(&Index);
+}
+
+/* SMBIOS_STREAM_ROUTINE */
+static
+bool
+MatchStreamStructure(
+    void* UserData,
+    PSMBIOS_TABLE Table,
+    DWORD Offset,
+    DWORD Size)
+{
+    PFUZZ_WALK Walk = (PFUZZ_WALK)UserData;
+
+    if (Walk->Streamed >= Walk->Count ||
+        Walk->Structures[Walk->Streamed].Offset != Offset ||
+        Walk->Structures[Walk->Streamed].Size != Size)
+    {
+        Walk->Mismatch = true;
+        return false;
+    }
+    Walk->Streamed++;
+    return true;
+}
+
+/* Parsing may fail only where whole table walk stops too, or on a structure too large to buffer */
+static
+void
+CheckStream(
+    const BYTE* Data,
+    DWORD Size,
+    size_t ChunkSize,
+    PFUZZ_WALK Walk)
+{
+    SMBIOS_STREAM_PARSER Parser = { 0 };
+    size_t Offset, Length;
+    bool Result = true;
+
+    Walk->Streamed = 0;
+    Walk->Mismatch = false;
+    Parser.Routine = MatchStreamStructure;
+    Parser.UserData = Walk;
+    for (Offset = 0; Offset < Size && Result; Offset += Length)
+    {
+        Length = Size - Offset < ChunkSize ? Size - Offset : ChunkSize;
+        Result = SmbiosFeedStreamParser(&Parser, Data + Offset, Length);
+    }
+    Result = SmbiosFinishStreamParser(&Parser) && Result;
+    Check(!Walk->Mismatch, "stream parser splits structures as walk");
+    if (Result)
+    {
+        Check(Walk->Streamed == Walk->Count, "stream parser has as many structures as walk");
+    } else if (Walk->Streamed < Walk->Count)
+    {
+        Check(Walk->Structures[Walk->Streamed].Size > SMBIOS_STREAM_MAX_STRUCTURE_SIZE, "stream parser fails only on too large structure");
+    }
+}
+
+static
+SMBIOS_VISIT_ACTION
+CountField(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PFUZZ_DECODE_COUNT Count = (PFUZZ_DECODE_COUNT)UserData;
+    PSMBIOS_FIELD_TYPE_INFO Field = Value->Field;
+    size_t Text;
+
+    Check(Field->IsBitField || Field->Offset + Field->Size <= Context->Length, "field within structure");
+
+    /* Strings were checked terminated, as resolved by the same walk */
+    Text = strlen(Field->Name);
+    if (Value->Enum != NULL)
+    {
+        Text += strlen((const char*)Value->Enum->Name);
+    }
+    if (Value->String != NULL)
+    {
+        Text += strlen(Value->String);
+    }
+    Count->Output += FUZZ_FIELD_OUTPUT + Text * FUZZ_ESCAPE_RATIO;
+    if (!Field->IsBitField)
+    {
+        Count->Output += (size_t)Field->Size * FUZZ_BYTE_OUTPUT;
+    }
+    Count->Fields++;
+    return SmbiosVisitContinue;
+}
+
+static
+void
+CheckDecode(
+    const BYTE* Data,
+    DWORD Size,
+    const FUZZ_WALK* Walk)
+{
+    SMBIOS_DECODE_CONTEXT Context;
+    SMBIOS_TEXT_WRITER Writer;
+    SMBIOS_JSON_PRINTER JsonPrinter;
+    SMBIOS_VISITOR Printer;
+    FUZZ_DECODE_COUNT Count = { 0 };
+    SMBIOS_VISITOR Counter = { &Count, NULL, CountField, CountField, CountField, NULL };
+    size_t MaxOutput;
+    int i;
+
+    /* Interpreted plans, counting fields */
+    Check(SmbiosInitializeContext(&Context, Data, Size, &InterpretPlans), "initialize context");
+    SmbiosVisitTable(&Context, &Counter);
+    SmbiosUninitializeContext(&Context);
+    Check(Count.Fields <= Walk->Count * MaxStepCount, "fields within structures");
+
+    /* Generated visit functions, text then JSON */
+    MaxOutput = Walk->Count * FUZZ_STRUCTURE_OUTPUT + Count.Output;
+    for (i = 0; i < 2; i++)
+    {
+        Check(SmbiosInitializeWriter(&Writer, NULL, 0), "initialize writer");
+        if (i == 0)
+        {
+            SmbiosInitializeTextPrinter(&Writer, &Printer);
+        } else
+        {
+            SmbiosInitializeJsonPrinter(&JsonPrinter, &Writer, &Printer);
+        }
+        Check(SmbiosInitializeContext(&Context, Data, Size, &Plans), "initialize context");
+        SmbiosVisitTable(&Context, &Printer);
+        SmbiosUninitializeContext(&Context);
+        Check(!Writer.Failed, "write output");
+        Check(Writer.Used <= MaxOutput, "output within input size");
+        SmbiosUninitializeWriter(&Writer);
+    }
+}
+
+int
+LLVMFuzzerTestOneInput(
+    const uint8_t* Data,
+    size_t Size)
+{
+    FUZZ_WALK Walk;
+    clock_t Start;
+
+    if (Size > (DWORD)~0)
+    {
+        return 0;
+    }
+    Initialize();
+    Start = clock();
+    WalkTable(Data, (DWORD)Size, &Walk);
+    CheckContext(Data, (DWORD)Size, &Walk);
+    CheckIndex(Data, (DWORD)Size, &Walk);
+    CheckStream(Data, (DWORD)Size, Size, &Walk);
+    CheckStream(Data, (DWORD)Size, Size != 0 ? 1 + Data[0] % 13 : 1, &Walk);
+    CheckDecode(Data, (DWORD)Size, &Walk);
+    free(Walk.Structures);
+    Check((double)(clock() - Start) / CLOCKS_PER_SEC <= FUZZ_TIME_BASE + (double)Size / FUZZ_BYTES_PER_SECOND,
+          "processor time within input size");
+    return 0;
+}
+
+#if !defined(SMBIOS_FUZZ_LIBFUZZER)
+
+static
+bool
+WriteSeedCorpus(
+    const char* Directory)
+{
+    SMBIOS_CORPUS_OPTIONS Options;
+    PSMBIOS_RAW_DATA Table;
+    char Path[1024];
+    FILE* File;
+    size_t i, Written;
+    DWORD Length;
+
+    for (i = 0; i < sizeof(SeedTables) / sizeof(SeedTables[0]); i++)
+    {
+        SmbiosInitializeCorpusOptions(&Options);
+        if ((strcmp(SeedTables[i], "default") != 0 && !SmbiosParseCorpusOptions(SeedTables[i], &Options)) ||
+            !SmbiosGenerateTable(&Options, &Table))
+        {
+            printf("Generate seed failed: %s\n", SeedTables[i]);
+            return false;
+        }
+        snprintf(Path, sizeof(Path), "%s/seed%02zu.bin", Directory, i);
+        Length = Table->Length;
+        File = fopen(Path, "wb");
+        Written = File != NULL ? fwrite(Table->SMBIOSTableData, 1, Length, File) : 0;
+        free(Table);
+        if (File == NULL || fclose(File) != 0 || Written != Length)
+        {
+            printf("Write seed failed: %s\n", Path);
+            return false;
+        }
+    }
+    return true;
+}
+
+static
+bool
+RunFile(
+    FILE* File)
+{
+    BYTE* Data = NULL;
+    BYTE* NewData;
+    size_t Size = 0, Capacity = 0, Read;
+
+    do
+    {
+        if (Size == Capacity)
+        {
+            Capacity = Capacity != 0 ? Capacity * 2 : 0x10000;
+            NewData = (BYTE*)realloc(Data, Capacity);
+            if (NewData == NULL)
+            {
+                free(Data);
+                return false;
+            }
+            Data = NewData;
+        }
+        Read = fread(Data + Size, 1, Capacity - Size, File);
+        Size += Read;
+    } while (Read != 0);
+    LLVMFuzzerTestOneInput(Data, Size);
+    free(Data);
+    return !ferror(File);
+}
+
+int
+main(
+    int argc,
+    char* argv[])
+{
+    FILE* File;
+    bool Result;
+    int i;
+
+    if (argc == 3 && strcmp(argv[1], "--seed-corpus") == 0)
+    {
+        return WriteSeedCorpus(argv[2]) ? 0 : EIO;
+    }
+    if (argc == 1)
+    {
+        return RunFile(stdin) ? 0 : EIO;
+    }
+    for (i = 1; i < argc; i++)
+    {
+        File = fopen(argv[i], "rb");
+        Result = File != NULL && RunFile(File);
+        if (File != NULL)
+        {
+            fclose(File);
+        }
+        if (!Result)
+        {
+            printf("Read input failed: %s\n", argv[i]);
+            return EIO;
+        }
+    }
+    return 0;
+}
+
+#endif
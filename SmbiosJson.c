@@ -0,0 +1,386 @@
+﻿#include "SmbiosJson.h"
+
+static const char* const JsonTypeNames[] = { "other", "string", "uint", "bit", "enum", "uuid", "raw" };
+
+/* Length of a well-formed UTF-8 sequence at Text, 0 if it is not */
+static
+size_t
+GetUtf8SequenceLength(
+    const BYTE* Text)
+{
+    BYTE Low = 0x80, High = 0xBF;
+    size_t Length, i;
+
+    if (Text[0] < 0x80)
+    {
+        return 1;
+    } else if (Text[0] < 0xC2)
+    {
+        return 0;
+    } else if (Text[0] < 0xE0)
+    {
+        Length = 2;
+    } else if (Text[0] < 0xF0)
+    {
+        Length = 3;
+        if (Text[0] == 0xE0)
+        {
+            Low = 0xA0;
+        } else if (Text[0] == 0xED)
+        {
+            High = 0x9F;
+        }
+    } else if (Text[0] < 0xF5)
+    {
+        Length = 4;
+        if (Text[0] == 0xF0)
+        {
+            Low = 0x90;
+        } else if (Text[0] == 0xF4)
+        {
+            High = 0x8F;
+        }
+    } else
+    {
+        return 0;
+    }
+
+    /* Stops at the terminating NUL */
+    if (Text[1] < Low || Text[1] > High)
+    {
+        return 0;
+    }
+    for (i = 2; i < Length; i++)
+    {
+        if (Text[i] < 0x80 || Text[i] > 0xBF)
+        {
+            return 0;
+        }
+    }
+    return Length;
+}
+
+void
+SmbiosWriteJsonString(
+    PSMBIOS_TEXT_WRITER Writer,
+    const char* Text)
+{
+    const BYTE* p = (const BYTE*)Text;
+    const BYTE* Run = p;
+    size_t Length;
+    char Escape;
+
+    SmbiosWriteChar(Writer, '"');
+    while (*p != '\0')
+    {
+        /* Copy plain characters in runs */
+        if (*p >= 0x20 && *p < 0x80 && *p != '"' && *p != '\\')
+        {
+            p++;
+            continue;
+        }
+        if (*p >= 0x80)
+        {
+            Length = GetUtf8SequenceLength(p);
+            if (Length != 0)
+            {
+                p += Length;
+                continue;
+            }
+        }
+
+        SmbiosWriteText(Writer, (const char*)Run, p - Run);
+        switch (*p)
+        {
+        case '"':
+            Escape = '"';
+            break;
+        case '\\':
+            Escape = '\\';
+            break;
+        case '\b':
+            Escape = 'b';
+            break;
+        case '\f':
+            Escape = 'f';
+            break;
+        case '\n':
+            Escape = 'n';
+            break;
+        case '\r':
+            Escape = 'r';
+            break;
+        case '\t':
+            Escape = 't';
+            break;
+        default:
+            Escape = '\0';
+            break;
+        }
+        if (Escape != '\0')
+        {
+            SmbiosWriteChar(Writer, '\\');
+            SmbiosWriteChar(Writer, Escape);
+        } else
+        {
+            /* Control characters, and bytes not in UTF-8 sequence as Latin-1 code points */
+            SmbiosWriteString(Writer, "\\u00");
+            SmbiosWriteHex(Writer, *p, 2);
+        }
+        Run = ++p;
+    }
+    SmbiosWriteText(Writer, (const char*)Run, p - Run);
+    SmbiosWriteChar(Writer, '"');
+}
+
+static
+void
+CloseField(
+    PSMBIOS_JSON_PRINTER Printer)
+{
+    if (Printer->InBits)
+    {
+        SmbiosWriteChar(Printer->Writer, ']');
+        Printer->InBits = false;
+    }
+    if (Printer->FieldOpen)
+    {
+        SmbiosWriteChar(Printer->Writer, '}');
+        Printer->FieldOpen = false;
+    }
+}
+
+/* Open a field object and leave it open for bit fields */
+static
+void
+BeginField(
+    PSMBIOS_JSON_PRINTER Printer,
+    PSMBIOS_FIELD_TYPE_INFO Field)
+{
+    PSMBIOS_TEXT_WRITER Writer = Printer->Writer;
+
+    CloseField(Printer);
+    SmbiosWriteString(Writer, Printer->FirstField ? "{\"offset\":" : ",{\"offset\":");
+    Printer->FirstField = false;
+    Printer->FieldOpen = true;
+    SmbiosWriteDecimal(Writer, Field->Offset, 0);
+    SmbiosWriteString(Writer, ",\"name\":");
+    SmbiosWriteJsonString(Writer, Field->Name);
+    SmbiosWriteString(Writer, ",\"type\":\"");
+    SmbiosWriteString(Writer, JsonTypeNames[Field->Type]);
+    SmbiosWriteChar(Writer, '"');
+}
+
+/* Open a bit field object in "bits" array of current field */
+static
+void
+BeginBitField(
+    PSMBIOS_JSON_PRINTER Printer,
+    PSMBIOS_FIELD_TYPE_INFO Field)
+{
+    PSMBIOS_TEXT_WRITER Writer = Printer->Writer;
+
+    if (Printer->InBits)
+    {
+        SmbiosWriteChar(Writer, ',');
+    } else
+    {
+        if (!Printer->FieldOpen)
+        {
+            /* Keep the output valid even if the parent integer was not visited */
+            SmbiosWriteString(Writer, Printer->FirstField ? "{" : ",{");
+            Printer->FirstField = false;
+            Printer->FieldOpen = true;
+        } else
+        {
+            SmbiosWriteChar(Writer, ',');
+        }
+        SmbiosWriteString(Writer, "\"bits\":[");
+        Printer->InBits = true;
+    }
+
+    if (Field->Type == SmbiosDataTypeBit)
+    {
+        SmbiosWriteString(Writer, "{\"bit\":");
+        SmbiosWriteDecimal(Writer, (BYTE)Field->Offset, 0);
+    } else
+    {
+        SmbiosWriteString(Writer, "{\"bits\":[");
+        SmbiosWriteDecimal(Writer, (BYTE)Field->Offset, 0);
+        SmbiosWriteChar(Writer, ',');
+        SmbiosWriteDecimal(Writer, (BYTE)(Field->Offset + Field->Size - 1), 0);
+        SmbiosWriteChar(Writer, ']');
+    }
+    SmbiosWriteString(Writer, ",\"name\":");
+    SmbiosWriteJsonString(Writer, Field->Name);
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintJsonStructure(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context)
+{
+    PSMBIOS_JSON_PRINTER Printer = (PSMBIOS_JSON_PRINTER)UserData;
+    PSMBIOS_TEXT_WRITER Writer = Printer->Writer;
+    PSMBIOS_TABLE Table = Context->Table;
+
+    SmbiosWriteString(Writer, "{\"type\":");
+    SmbiosWriteDecimal(Writer, Table->Header.Type, 0);
+    SmbiosWriteString(Writer, ",\"name\":");
+    if (Context->TypeInfo != NULL)
+    {
+        SmbiosWriteJsonString(Writer, Context->TypeInfo->Name);
+    } else
+    {
+        SmbiosWriteString(Writer, "null");
+    }
+    SmbiosWriteString(Writer, ",\"handle\":");
+    SmbiosWriteDecimal(Writer, Table->Header.Handle, 0);
+    SmbiosWriteString(Writer, ",\"offset\":");
+    if (Context->PartialTable)
+    {
+        SmbiosWriteString(Writer, "null");
+    } else
+    {
+        SmbiosWriteDecimal(Writer, Context->Offset, 0);
+    }
+    SmbiosWriteString(Writer, ",\"length\":");
+    SmbiosWriteDecimal(Writer, Table->Header.Length, 0);
+    SmbiosWriteString(Writer, ",\"size\":");
+    SmbiosWriteDecimal(Writer, Context->Size, 0);
+    SmbiosWriteString(Writer, ",\"fields\":[");
+    Printer->FirstField = true;
+    Printer->FieldOpen = false;
+    Printer->InBits = false;
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintJsonStructureEnd(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context)
+{
+    PSMBIOS_JSON_PRINTER Printer = (PSMBIOS_JSON_PRINTER)UserData;
+
+    CloseField(Printer);
+    SmbiosWriteString(Printer->Writer, "]}\n");
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintJsonString(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_JSON_PRINTER Printer = (PSMBIOS_JSON_PRINTER)UserData;
+    PSMBIOS_TEXT_WRITER Writer = Printer->Writer;
+
+    BeginField(Printer, Value->Field);
+    SmbiosWriteString(Writer, ",\"index\":");
+    SmbiosWriteDecimal(Writer, (BYTE)Value->Value, 0);
+    SmbiosWriteString(Writer, ",\"value\":");
+    if (Value->String != NULL)
+    {
+        SmbiosWriteJsonString(Writer, Value->String);
+    } else
+    {
+        SmbiosWriteString(Writer, "null");
+    }
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintJsonBit(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_JSON_PRINTER Printer = (PSMBIOS_JSON_PRINTER)UserData;
+
+    BeginBitField(Printer, Value->Field);
+    SmbiosWriteString(Printer->Writer, Value->Value ? ",\"value\":true}" : ",\"value\":false}");
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintJsonField(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_JSON_PRINTER Printer = (PSMBIOS_JSON_PRINTER)UserData;
+    PSMBIOS_TEXT_WRITER Writer = Printer->Writer;
+    PSMBIOS_FIELD_TYPE_INFO Field = Value->Field;
+
+    if (Field->IsBitField)
+    {
+        /* Only integers could be split into bits */
+        BeginBitField(Printer, Field);
+        SmbiosWriteString(Writer, ",\"type\":\"");
+        SmbiosWriteString(Writer, JsonTypeNames[Field->Type]);
+        SmbiosWriteChar(Writer, '"');
+    } else
+    {
+        BeginField(Printer, Field);
+    }
+
+    if (Field->Type == SmbiosDataTypeUInt || Field->Type == SmbiosDataTypeEnum)
+    {
+        if (!Field->IsBitField)
+        {
+            SmbiosWriteString(Writer, ",\"size\":");
+            SmbiosWriteDecimal(Writer, Value->Size, 0);
+        }
+        SmbiosWriteString(Writer, ",\"value\":");
+        SmbiosWriteDecimal(Writer, Value->Value, 0);
+        if (Value->Enum != NULL)
+        {
+            SmbiosWriteString(Writer, ",\"enum\":");
+            SmbiosWriteJsonString(Writer, (const char*)Value->Enum->Name);
+        }
+    } else if (Field->IsBitField)
+    {
+        /* No value for other types of bit fields */
+    } else if (Field->Type == SmbiosDataTypeUuid && Field->Size == 16)
+    {
+        SmbiosWriteString(Writer, ",\"value\":\"");
+        SmbiosWriteUuid(Writer, (const BYTE*)Value->Data);
+        SmbiosWriteChar(Writer, '"');
+    } else
+    {
+        SmbiosWriteString(Writer, ",\"value\":\"");
+        SmbiosWriteBytes(Writer, (const BYTE*)Value->Data, Field->Size);
+        SmbiosWriteChar(Writer, '"');
+    }
+
+    if (Field->IsBitField)
+    {
+        SmbiosWriteChar(Writer, '}');
+    }
+    return SmbiosVisitContinue;
+}
+
+void
+SmbiosInitializeJsonPrinter(
+    PSMBIOS_JSON_PRINTER Printer,
+    PSMBIOS_TEXT_WRITER Writer,
+    PSMBIOS_VISITOR Visitor)
+{
+    Printer->Writer = Writer;
+    Printer->FirstField = true;
+    Printer->FieldOpen = false;
+    Printer->InBits = false;
+
+    Visitor->UserData = Printer;
+    Visitor->OnStructure = PrintJsonStructure;
+    Visitor->OnField = PrintJsonField;
+    Visitor->OnString = PrintJsonString;
+    Visitor->OnBit = PrintJsonBit;
+    Visitor->OnStructureEnd = PrintJsonStructureEnd;
+}
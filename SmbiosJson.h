@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "SmbiosVisit.h"
+#include "SmbiosWriter.h"
+
+#include <stdbool.h>
+
+/*
+ * NDJSON output, one object per structure on its own line, written while visiting so nothing is held back
+ * for the whole table:
+ *
+ * {"type":17,"name":"Memory Device","handle":4096,"offset":1234,"length":40,"size":88,"fields":[...]}
+ *
+ * Offset is in the firmware table, or null if only some structures of the table were read (e.g. by type).
+ * Each field is {"offset":N,"name":"...","type":"...","value":...} in structure order, where type and value are
+ *   "uint"       Number, and "size" in bytes
+ *   "enum"       Number, "size" in bytes, and "enum" name if matched
+ *   "string"     Resolved string or null, and "index" of the string
+ *   "uuid"       "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"
+ *   "raw"/"other" Field bytes in hex separated by spaces
+ * Bit fields of an integer are in its "bits" array, as {"bit":N,"name":"...","value":true} for single bits, or
+ * {"bits":[Low,High],"name":"...","type":"uint"/"enum","value":N} with optional "enum" for multi-bit fields.
+ * Unrecognized structures have null name and empty fields.
+ */
+typedef struct _SMBIOS_JSON_PRINTER
+{
+    PSMBIOS_TEXT_WRITER Writer;
+
+    /* Private */
+    bool FirstField;
+    bool FieldOpen;                 // Current field object is not closed yet, bit fields may be appended
+    bool InBits;
+} SMBIOS_JSON_PRINTER, *PSMBIOS_JSON_PRINTER;
+
+/* Set up Printer on Writer and fill Visitor with its callbacks, Printer must outlive the Visitor */
+void
+SmbiosInitializeJsonPrinter(
+    PSMBIOS_JSON_PRINTER Printer,
+    PSMBIOS_TEXT_WRITER Writer,
+    PSMBIOS_VISITOR Visitor);
+
+/* Write Text as a quoted JSON string, valid UTF-8 is kept as is and other bytes are taken as Latin-1 */
+void
+SmbiosWriteJsonString(
+    PSMBIOS_TEXT_WRITER Writer,
+    const char* Text);
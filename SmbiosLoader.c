@@ -0,0 +1,872 @@
+﻿#include "SmbiosLoader.h"
+#include "SmbiosTable.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+static const char SmbiosEntryPointAnchorString21[] = SMBIOS_ENTRY_POINT_21_ANCHOR_STRING;
+static const char SmbiosEntryPointAnchorString21DMI[] = SMBIOS_ENTRY_POINT_21_ANCHOR_STRING2;
+static const char SmbiosEntryPointAnchorString30[] = SMBIOS_ENTRY_POINT_30_ANCHOR_STRING;
+
+/* Value of checksum byte for Data to sum to 0, so 0 over data with a valid checksum */
+static
+BYTE
+Checksum(
+    const BYTE* Data,
+    size_t Size)
+{
+    BYTE Sum = 0;
+
+    while (Size-- != 0)
+    {
+        Sum += *Data++;
+    }
+    return (BYTE)(0 - Sum);
+}
+
+/* Entry points are searched in the 64 KiB segment of 0xF0000 by the specification */
+#define ENTRY_POINT_SEGMENT_SIZE 0x10000
+
+/* Legacy DMI entry point is the same as the intermediate part of a 2.1 one */
+#define LEGACY_ENTRY_POINT_OFFSET offsetof(SMBIOS_ENTRY_POINT_21, AnchorString2)
+#define LEGACY_ENTRY_POINT_LENGTH (sizeof(SMBIOS_ENTRY_POINT_21) - LEGACY_ENTRY_POINT_OFFSET)
+
+/* Some 2.1 firmware reports 0x1E for the 0x1F bytes long entry point, checksum is of the reported length */
+#define ENTRY_POINT_21_MIN_LENGTH 0x1E
+
+bool
+SmbiosParseEntryPoint(
+    const void* Buffer,
+    size_t Size,
+    PSMBIOS_ENTRY_POINT_INFO Info)
+{
+    const BYTE* p = (const BYTE*)Buffer;
+    const BYTE* Legacy = p + LEGACY_ENTRY_POINT_OFFSET;
+    SMBIOS_ENTRY_POINT_30 Ep30;
+    SMBIOS_ENTRY_POINT_21 Ep21;
+
+    /* Structures are packed and copied out of the buffer as a whole, which may not be aligned */
+    memset(Info, 0, sizeof(*Info));
+    if (Size >= sizeof(SMBIOS_ENTRY_POINT_30) &&
+        memcmp(p, SmbiosEntryPointAnchorString30, sizeof(SmbiosEntryPointAnchorString30)) == 0)
+    {
+        memcpy(&Ep30, p, sizeof(Ep30));
+        if (Ep30.Length < sizeof(Ep30) || Ep30.Length > Size || Checksum(p, Ep30.Length) != 0)
+        {
+            return false;
+        }
+        Info->Format = SmbiosEntryPoint30;
+        Info->Length = Ep30.Length;
+        Info->MajorVersion = Ep30.MajorVersion;
+        Info->MinorVersion = Ep30.MinorVersion;
+        Info->TableLength = Ep30.TableMaxSize;
+        Info->TableAddress = Ep30.TableAddress;
+        return true;
+    }
+
+    if (Size >= sizeof(SMBIOS_ENTRY_POINT_21) &&
+        memcmp(p, SmbiosEntryPointAnchorString21, sizeof(SmbiosEntryPointAnchorString21)) == 0)
+    {
+        memcpy(&Ep21, p, sizeof(Ep21));
+        if (Ep21.Length < ENTRY_POINT_21_MIN_LENGTH || Ep21.Length > Size || Checksum(p, Ep21.Length) != 0)
+        {
+            return false;
+        }
+        Info->Format = SmbiosEntryPoint21;
+        Info->Length = Ep21.Length;
+        Info->MajorVersion = Ep21.MajorVersion;
+        Info->MinorVersion = Ep21.MinorVersion;
+        Info->MaxStructureSize = Ep21.MaxStructureSize;
+        p = Legacy;
+    } else if (Size >= LEGACY_ENTRY_POINT_LENGTH)
+    {
+        memset(&Ep21, 0, sizeof(Ep21));
+        memcpy(Ep21.AnchorString2, p, LEGACY_ENTRY_POINT_LENGTH);
+        Info->Format = SmbiosEntryPointLegacy;
+        Info->Length = (BYTE)LEGACY_ENTRY_POINT_LENGTH;
+        Info->MajorVersion = Ep21.BCDRevision.MajorVersion;
+        Info->MinorVersion = Ep21.BCDRevision.MinorVersion;
+    } else
+    {
+        return false;
+    }
+
+    /* Intermediate (legacy) part has its own anchor and checksum */
+    if (memcmp(Ep21.AnchorString2, SmbiosEntryPointAnchorString21DMI, sizeof(SmbiosEntryPointAnchorString21DMI)) != 0 ||
+        Checksum(p, LEGACY_ENTRY_POINT_LENGTH) != 0)
+    {
+        return false;
+    }
+    Info->TableLength = Ep21.TableLength;
+    Info->TableAddress = Ep21.TableAddress;
+    Info->NumberOfStructures = Ep21.NumberOfStructures;
+    return true;
+}
+
+static
+void
+SetEntryPointHeader(
+    const SMBIOS_ENTRY_POINT_INFO* Info,
+    PSMBIOS_RAW_DATA Header)
+{
+    Header->SMBIOSMajorVersion = Info->MajorVersion;
+    Header->SMBIOSMinorVersion = Info->MinorVersion;
+    Header->Length = Info->TableLength;
+    Header->DmiRevision = Info->Format == SmbiosEntryPoint30 ? 3 : 2;
+}
+
+bool
+ParseSmbiosEntryPoint(
+    const void* Buffer,
+    size_t Size,
+    PSMBIOS_RAW_DATA Header)
+{
+    SMBIOS_ENTRY_POINT_INFO Info;
+
+    if (!SmbiosParseEntryPoint(Buffer, Size, &Info))
+    {
+        return false;
+    }
+    SetEntryPointHeader(&Info, Header);
+    return true;
+}
+
+/* Starts with any anchor, valid or not */
+static
+bool
+HasEntryPointAnchor(
+    const void* Buffer,
+    size_t Size)
+{
+    return (Size >= sizeof(SmbiosEntryPointAnchorString30) &&
+            memcmp(Buffer, SmbiosEntryPointAnchorString30, sizeof(SmbiosEntryPointAnchorString30)) == 0) ||
+           (Size >= sizeof(SmbiosEntryPointAnchorString21) &&
+            memcmp(Buffer, SmbiosEntryPointAnchorString21, sizeof(SmbiosEntryPointAnchorString21)) == 0) ||
+           (Size >= sizeof(SmbiosEntryPointAnchorString21DMI) &&
+            memcmp(Buffer, SmbiosEntryPointAnchorString21DMI, sizeof(SmbiosEntryPointAnchorString21DMI)) == 0);
+}
+
+static
+bool
+ReadSmbiosEntryPointFile(
+    const char* Path,
+    PSMBIOS_RAW_DATA Header)
+{
+    FILE* File;
+    BYTE Buffer[sizeof(SMBIOS_ENTRY_POINT_21) > sizeof(SMBIOS_ENTRY_POINT_30) ?
+                sizeof(SMBIOS_ENTRY_POINT_21) : sizeof(SMBIOS_ENTRY_POINT_30)];
+    size_t Size;
+
+    File = fopen(Path, "rb");
+    if (File == NULL)
+    {
+        printf("open failed with: %d\n", errno);
+        return false;
+    }
+    Size = fread(Buffer, 1, sizeof(Buffer), File);
+    fclose(File);
+    if (!ParseSmbiosEntryPoint(Buffer, Size, Header))
+    {
+        puts("Read SMBIOS entry point failed");
+        return false;
+    }
+    Header->Used20CallingMethod = 0;
+    return true;
+}
+
+/* Fill view header, table length in entry point is trusted only within the data actually read */
+static
+void
+SetTableView(
+    PSMBIOS_TABLE_VIEW View,
+    const SMBIOS_RAW_DATA* Header,
+    const void* TableData,
+    size_t TableSize)
+{
+    View->Used20CallingMethod = Header->Used20CallingMethod;
+    View->SMBIOSMajorVersion = Header->SMBIOSMajorVersion;
+    View->SMBIOSMinorVersion = Header->SMBIOSMinorVersion;
+    View->DmiRevision = Header->DmiRevision;
+    View->Length = Header->Length < TableSize ? Header->Length : (DWORD)TableSize;
+    View->SMBIOSTableData = (const BYTE*)TableData;
+    View->Partial = false;
+}
+
+#if defined(_WIN32)
+
+#include <Windows.h>
+
+bool
+GetSmbiosTableData(
+    PSMBIOS_RAW_DATA* Data)
+{
+    UINT BufferSize, BytesWritten;
+    PVOID Buffer;
+
+    BufferSize = GetSystemFirmwareTable('RSMB', 0, NULL, 0);
+    if (BufferSize == 0)
+    {
+        printf("GetSystemFirmwareTable failed with: 0x%08lX\n", GetLastError());
+        return false;
+    }
+    Buffer = malloc(BufferSize);
+    if (Buffer == NULL)
+    {
+        printf("malloc failed to allocate %lu bytes buffer\n", BufferSize);
+        return false;
+    }
+    BytesWritten = GetSystemFirmwareTable('RSMB', 0, Buffer, BufferSize);
+    if (BytesWritten == 0)
+    {
+        printf("GetSystemFirmwareTable failed with: 0x%08lX\n", GetLastError());
+    } else if (BytesWritten != BufferSize)
+    {
+        printf("Read size (%lu) is not match expected size (%lu)", BytesWritten, BufferSize);
+    } else
+    {
+        *Data = (PSMBIOS_RAW_DATA)Buffer;
+        return true;
+    }
+
+    free(Buffer);
+    return false;
+}
+
+bool
+MapSmbiosTableData(
+    PSMBIOS_TABLE_VIEW View)
+{
+    PSMBIOS_RAW_DATA Data;
+
+    /* GetSystemFirmwareTable can only copy */
+    if (!GetSmbiosTableData(&Data))
+    {
+        return false;
+    }
+    View->Base = Data;
+    View->Size = 0;
+    View->Mapped = false;
+    SetTableView(View, Data, Data->SMBIOSTableData, Data->Length);
+    return true;
+}
+
+bool
+MapSmbiosTableTypes(
+    const bool Types[UCHAR_MAX + 1],
+    PSMBIOS_TABLE_VIEW View)
+{
+    /* GetSystemFirmwareTable has no per-structure access */
+    return MapSmbiosTableData(View);
+}
+
+static
+bool
+MapFile(
+    const char* Path,
+    QWORD MaxSize,
+    PSMBIOS_TABLE_VIEW View)
+{
+    HANDLE File, Mapping;
+    LARGE_INTEGER Size;
+    PVOID Base;
+
+    File = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (File == INVALID_HANDLE_VALUE)
+    {
+        printf("CreateFile failed with: 0x%08lX\n", GetLastError());
+        return false;
+    }
+    Base = NULL;
+    if (!GetFileSizeEx(File, &Size) || Size.QuadPart == 0 || (ULONGLONG)Size.QuadPart > MaxSize)
+    {
+        printf("Invalid file size\n");
+        goto _exit_0;
+    }
+    Mapping = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (Mapping == NULL)
+    {
+        printf("CreateFileMapping failed with: 0x%08lX\n", GetLastError());
+        goto _exit_0;
+    }
+    Base = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (Base == NULL)
+    {
+        printf("MapViewOfFile failed with: 0x%08lX\n", GetLastError());
+    }
+    CloseHandle(Mapping);
+
+_exit_0:
+    CloseHandle(File);
+    if (Base == NULL)
+    {
+        return false;
+    }
+    View->Base = Base;
+    View->Size = (size_t)Size.QuadPart;
+    View->Mapped = true;
+    return true;
+}
+
+void
+UnmapSmbiosTableData(
+    PSMBIOS_TABLE_VIEW View)
+{
+    if (View->Mapped)
+    {
+        UnmapViewOfFile(View->Base);
+    } else
+    {
+        free(View->Base);
+    }
+    memset(View, 0, sizeof(*View));
+}
+
+#elif defined(__linux__)
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define DMI_ENTRIES_PATH "/sys/firmware/dmi/entries"
+#define DMI_ENTRIES_INITIAL_SIZE 0x1000
+
+static
+bool
+ReadFileData(
+    int fd,
+    void* Buffer,
+    size_t Size)
+{
+    size_t BytesRead;
+    ssize_t i;
+
+    BytesRead = 0;
+    do
+    {
+        i = read(fd, AddPtr(Buffer, BytesRead), Size - BytesRead);
+        if (i < 0)
+        {
+            printf("read failed with: %d\n", errno);
+            return false;
+        }
+        BytesRead += i;
+    } while (i > 0 && BytesRead < Size);
+    if (BytesRead != Size)
+    {
+        printf("Read size (%zu) is not match expected size (%zu)\n", BytesRead, Size);
+        return false;
+    }
+    return true;
+}
+
+bool
+GetSmbiosTableData(
+    PSMBIOS_RAW_DATA* Data)
+{
+    int fd, ret;
+    struct stat sb;
+    PSMBIOS_RAW_DATA p;
+    size_t size;
+
+    fd = open("/sys/firmware/dmi/tables/DMI", O_RDONLY);
+    if (fd < 0)
+    {
+        printf("open failed with: %d\n", errno);
+        return false;
+    }
+    ret = fstat(fd, &sb);
+    if (ret < 0)
+    {
+        printf("fstat failed with: %d\n", errno);
+        goto _exit_0;
+    }
+    size = sizeof(SMBIOS_RAW_DATA) + sb.st_size;
+    p = (PSMBIOS_RAW_DATA)malloc(size);
+    if (p == NULL)
+    {
+        printf("malloc failed to allocate %zu bytes buffer\n", size);
+        goto _exit_0;
+    }
+    if (!ReadFileData(fd, p->SMBIOSTableData, sb.st_size))
+    {
+        goto _exit_1;
+    }
+    close(fd);
+
+    if (!ReadSmbiosEntryPointFile("/sys/firmware/dmi/tables/smbios_entry_point", p))
+    {
+        free(p);
+        return false;
+    }
+    if (p->Length > (size_t)sb.st_size)
+    {
+        p->Length = (DWORD)sb.st_size;
+    }
+
+    *Data = p;
+    return true;
+
+_exit_1:
+    free(p);
+_exit_0:
+    close(fd);
+    return false;
+}
+
+static
+bool
+MapFile(
+    const char* Path,
+    QWORD MaxSize,
+    PSMBIOS_TABLE_VIEW View)
+{
+    int fd;
+    struct stat sb;
+    void* Base;
+
+    fd = open(Path, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("open failed with: %d\n", errno);
+        return false;
+    }
+    if (fstat(fd, &sb) < 0)
+    {
+        printf("fstat failed with: %d\n", errno);
+        goto _exit_0;
+    }
+    if (sb.st_size <= 0 || (unsigned long long)sb.st_size > MaxSize)
+    {
+        printf("Invalid file size: %lld\n", (long long)sb.st_size);
+        goto _exit_0;
+    }
+
+    /* sysfs binary attributes may not support mmap, read them into a buffer without header instead */
+    Base = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (Base != MAP_FAILED)
+    {
+        View->Mapped = true;
+    } else
+    {
+        Base = malloc(sb.st_size);
+        if (Base == NULL)
+        {
+            printf("malloc failed to allocate %lld bytes buffer\n", (long long)sb.st_size);
+            goto _exit_0;
+        }
+        if (!ReadFileData(fd, Base, sb.st_size))
+        {
+            free(Base);
+            goto _exit_0;
+        }
+        View->Mapped = false;
+    }
+    close(fd);
+    View->Base = Base;
+    View->Size = sb.st_size;
+    return true;
+
+_exit_0:
+    close(fd);
+    return false;
+}
+
+bool
+MapSmbiosTableData(
+    PSMBIOS_TABLE_VIEW View)
+{
+    return MapSmbiosTableFile("/sys/firmware/dmi/tables/DMI", "/sys/firmware/dmi/tables/smbios_entry_point", View);
+}
+
+/*
+ * Read a whole file to the end of buffer, growing it by double. sysfs files of entries report no size, so they
+ * are read until end of file. Missing is set if the file does not exist.
+ */
+static
+bool
+AppendFileData(
+    const char* Path,
+    BYTE** Buffer,
+    size_t* Size,
+    size_t* Capacity,
+    bool* Missing)
+{
+    BYTE* NewBuffer;
+    size_t NewCapacity;
+    ssize_t i;
+    int fd;
+
+    *Missing = false;
+    fd = open(Path, O_RDONLY);
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+        {
+            *Missing = true;
+        } else
+        {
+            printf("open failed with: %d\n", errno);
+        }
+        return false;
+    }
+    do
+    {
+        if (*Size == *Capacity)
+        {
+            NewCapacity = *Capacity != 0 ? *Capacity * 2 : DMI_ENTRIES_INITIAL_SIZE;
+            NewBuffer = (BYTE*)realloc(*Buffer, NewCapacity);
+            if (NewBuffer == NULL)
+            {
+                printf("realloc failed to allocate %zu bytes buffer\n", NewCapacity);
+                close(fd);
+                return false;
+            }
+            *Buffer = NewBuffer;
+            *Capacity = NewCapacity;
+        }
+        i = read(fd, *Buffer + *Size, *Capacity - *Size);
+        if (i < 0)
+        {
+            printf("read failed with: %d\n", errno);
+            close(fd);
+            return false;
+        }
+        *Size += i;
+    } while (i > 0);
+    close(fd);
+    return true;
+}
+
+bool
+MapSmbiosTableTypes(
+    const bool Types[UCHAR_MAX + 1],
+    PSMBIOS_TABLE_VIEW View)
+{
+    SMBIOS_RAW_DATA Header = { 0 };
+    struct stat sb;
+    char Path[sizeof(DMI_ENTRIES_PATH "/255-4294967295/raw")];
+    BYTE* Buffer = NULL;
+    size_t Size = 0, Capacity = 0;
+    unsigned int Type, Instance;
+    bool Missing;
+
+    memset(View, 0, sizeof(*View));
+    if (stat(DMI_ENTRIES_PATH, &sb) != 0 || !S_ISDIR(sb.st_mode))
+    {
+        return MapSmbiosTableData(View);
+    }
+    if (!ReadSmbiosEntryPointFile("/sys/firmware/dmi/tables/smbios_entry_point", &Header))
+    {
+        return false;
+    }
+
+    /* Instances of a type are numbered from 0 without gaps, the first one missing is the end */
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        if (!Types[Type])
+        {
+            continue;
+        }
+        for (Instance = 0; ; Instance++)
+        {
+            snprintf(Path, sizeof(Path), DMI_ENTRIES_PATH "/%u-%u/raw", Type, Instance);
+            if (!AppendFileData(Path, &Buffer, &Size, &Capacity, &Missing))
+            {
+                if (Missing)
+                {
+                    break;
+                }
+                free(Buffer);
+                return false;
+            }
+        }
+    }
+    if (Size == 0 || Size > UINT32_MAX)
+    {
+        /* Table views are never empty */
+        free(Buffer);
+        return Size == 0 ? MapSmbiosTableData(View) : false;
+    }
+
+    Header.Length = (DWORD)Size;
+    View->Base = Buffer;
+    View->Size = Size;
+    View->Mapped = false;
+    SetTableView(View, &Header, Buffer, Size);
+    View->Partial = true;
+    return true;
+}
+
+void
+UnmapSmbiosTableData(
+    PSMBIOS_TABLE_VIEW View)
+{
+    if (View->Mapped)
+    {
+        munmap(View->Base, View->Size);
+    } else
+    {
+        free(View->Base);
+    }
+    memset(View, 0, sizeof(*View));
+}
+
+#else
+
+#error No OS target specified, currently supports Windows (_WIN32) and Linux (__linux__)
+
+#endif
+
+void
+AttachSmbiosTableData(
+    PSMBIOS_RAW_DATA Data,
+    PSMBIOS_TABLE_VIEW View)
+{
+    View->Base = Data;
+    View->Size = 0;
+    View->Mapped = false;
+    SetTableView(View, Data, Data->SMBIOSTableData, Data->Length);
+}
+
+bool
+MapSmbiosTableFile(
+    const char* TablePath,
+    const char* EntryPointPath,
+    PSMBIOS_TABLE_VIEW View)
+{
+    SMBIOS_RAW_DATA Header = { 0 };
+
+    memset(View, 0, sizeof(*View));
+    if (EntryPointPath != NULL)
+    {
+        if (!ReadSmbiosEntryPointFile(EntryPointPath, &Header))
+        {
+            return false;
+        }
+    }
+    if (!MapFile(TablePath, UINT32_MAX, View))
+    {
+        return false;
+    }
+
+    /* Without entry point the whole file is the table and version is unknown */
+    if (EntryPointPath == NULL)
+    {
+        Header.Length = (DWORD)View->Size;
+    }
+    SetTableView(View, &Header, View->Base, View->Size);
+    return true;
+}
+
+bool
+SaveSmbiosTableDump(
+    const char* Path,
+    const SMBIOS_TABLE_VIEW* View)
+{
+    union
+    {
+        SMBIOS_ENTRY_POINT_21 Ep21;
+        SMBIOS_ENTRY_POINT_30 Ep30;
+        BYTE Bytes[SMBIOS_DUMP_TABLE_OFFSET];
+    } Header;
+    PSMBIOS_TABLE Table, NextTable;
+    const void* EndOfData;
+    WORD Count, MaxSize;
+    BYTE StringCount;
+    FILE* File;
+    bool Result;
+
+    memset(&Header, 0, sizeof(Header));
+    if (View->SMBIOSMajorVersion >= 3 || View->Length > 0xFFFF)
+    {
+        memcpy(Header.Ep30.AnchorString, SmbiosEntryPointAnchorString30, sizeof(Header.Ep30.AnchorString));
+        Header.Ep30.Length = sizeof(Header.Ep30);
+        Header.Ep30.MajorVersion = View->SMBIOSMajorVersion;
+        Header.Ep30.MinorVersion = View->SMBIOSMinorVersion;
+        Header.Ep30.EntryPointRevision = 1;
+        Header.Ep30.TableMaxSize = View->Length;
+        Header.Ep30.TableAddress = SMBIOS_DUMP_TABLE_OFFSET;
+        Header.Ep30.Checksum = Checksum(Header.Bytes, sizeof(Header.Ep30));
+    } else
+    {
+        /* 2.1 entry point also describes structure count and maximum size */
+        Count = MaxSize = 0;
+        EndOfData = AddPtr(View->SMBIOSTableData, View->Length);
+        for (Table = (PSMBIOS_TABLE)View->SMBIOSTableData;
+             Table != NULL && SubPtr(Table, EndOfData) >= sizeof(SMBIOS_HEADER);
+             Table = NextTable)
+        {
+            NextTable = SmbiosWalkStructure(Table, EndOfData, NULL, &StringCount);
+            Count++;
+            if (SubPtr(Table, NextTable != NULL ? (const void*)NextTable : EndOfData) > MaxSize)
+            {
+                MaxSize = (WORD)SubPtr(Table, NextTable != NULL ? (const void*)NextTable : EndOfData);
+            }
+        }
+        memcpy(Header.Ep21.AnchorString, SmbiosEntryPointAnchorString21, sizeof(Header.Ep21.AnchorString));
+        Header.Ep21.Length = sizeof(Header.Ep21);
+        Header.Ep21.MajorVersion = View->SMBIOSMajorVersion;
+        Header.Ep21.MinorVersion = View->SMBIOSMinorVersion;
+        Header.Ep21.MaxStructureSize = MaxSize;
+        memcpy(Header.Ep21.AnchorString2, SmbiosEntryPointAnchorString21DMI, sizeof(Header.Ep21.AnchorString2));
+        Header.Ep21.TableLength = (WORD)View->Length;
+        Header.Ep21.TableAddress = SMBIOS_DUMP_TABLE_OFFSET;
+        Header.Ep21.NumberOfStructures = Count;
+        Header.Ep21.BCDRevision.MajorVersion = View->SMBIOSMajorVersion;
+        Header.Ep21.BCDRevision.MinorVersion = View->SMBIOSMinorVersion;
+        Header.Ep21.Checksum2 = Checksum(Header.Ep21.AnchorString2,
+                                         sizeof(Header.Ep21) - offsetof(SMBIOS_ENTRY_POINT_21, AnchorString2));
+        Header.Ep21.Checksum = Checksum(Header.Bytes, sizeof(Header.Ep21));
+    }
+
+    File = fopen(Path, "wb");
+    if (File == NULL)
+    {
+        printf("open failed with: %d\n", errno);
+        return false;
+    }
+    Result = fwrite(Header.Bytes, 1, sizeof(Header.Bytes), File) == sizeof(Header.Bytes) &&
+        fwrite(View->SMBIOSTableData, 1, View->Length, File) == View->Length;
+    if (fclose(File) != 0 || !Result)
+    {
+        printf("write failed with: %d\n", errno);
+        return false;
+    }
+    return true;
+}
+
+bool
+MapSmbiosTableDump(
+    const char* Path,
+    PSMBIOS_TABLE_VIEW View)
+{
+    SMBIOS_RAW_DATA Header = { 0 };
+    SMBIOS_ENTRY_POINT_INFO Info;
+    QWORD Offset;
+
+    memset(View, 0, sizeof(*View));
+    if (!MapFile(Path, UINT32_MAX, View))
+    {
+        return false;
+    }
+    if (!SmbiosParseEntryPoint(View->Base, View->Size, &Info))
+    {
+        /* A corrupt entry point is not taken as the start of a bare table */
+        if (HasEntryPointAnchor(View->Base, View->Size))
+        {
+            puts("Invalid SMBIOS entry point in dump file");
+            UnmapSmbiosTableData(View);
+            return false;
+        }
+        Header.Length = (DWORD)View->Size;
+        SetTableView(View, &Header, View->Base, View->Size);
+        return true;
+    }
+    SetEntryPointHeader(&Info, &Header);
+    Offset = Info.TableAddress;
+    if (Offset >= View->Size)
+    {
+        printf("Table address 0x%llX is out of dump file\n", Offset);
+        UnmapSmbiosTableData(View);
+        return false;
+    }
+    SetTableView(View, &Header, AddPtr(View->Base, Offset), View->Size - (size_t)Offset);
+    return true;
+}
+
+size_t
+SmbiosFindEntryPoint(
+    const void* Buffer,
+    size_t Size,
+    size_t Offset,
+    PSMBIOS_ENTRY_POINT_INFO Info)
+{
+    for (Offset = SmbiosScanAnchors(Buffer, Size, Offset); Offset < Size; Offset = SmbiosScanAnchors(Buffer, Size, Offset + 1))
+    {
+        if (SmbiosParseEntryPoint(AddPtr(Buffer, Offset), Size - Offset, Info))
+        {
+            return Offset;
+        }
+    }
+    return Size;
+}
+
+/* Offset of table described by entry point in image, or the image size if it is not all in the image */
+static
+size_t
+GetImageTableOffset(
+    const SMBIOS_ENTRY_POINT_INFO* Info,
+    QWORD BaseAddress,
+    size_t Size)
+{
+    QWORD Offset;
+
+    if (Info->TableAddress < BaseAddress || Info->TableLength == 0)
+    {
+        return Size;
+    }
+    Offset = Info->TableAddress - BaseAddress;
+    if (Offset >= Size || Info->TableLength > Size - Offset)
+    {
+        return Size;
+    }
+    return (size_t)Offset;
+}
+
+bool
+MapSmbiosTableImage(
+    const char* Path,
+    QWORD BaseAddress,
+    PSMBIOS_TABLE_VIEW View)
+{
+    SMBIOS_RAW_DATA Header = { 0 };
+    SMBIOS_ENTRY_POINT_INFO Info, Found;
+    size_t Offset, Table, TableOffset, End;
+
+    memset(View, 0, sizeof(*View));
+    if (!MapFile(Path, SIZE_MAX, View))
+    {
+        return false;
+    }
+
+    /* First entry point whose table is in the image, unless a 3.0 one follows in the same segment */
+    memset(&Found, 0, sizeof(Found));
+    TableOffset = End = View->Size;
+    for (Offset = SmbiosFindEntryPoint(View->Base, End, 0, &Info);
+         Offset < End;
+         Offset = SmbiosFindEntryPoint(View->Base, End, Offset + 1, &Info))
+    {
+        Table = GetImageTableOffset(&Info, BaseAddress, View->Size);
+        if (Table == View->Size)
+        {
+            continue;
+        }
+        if (TableOffset == View->Size)
+        {
+            End = View->Size - Offset > ENTRY_POINT_SEGMENT_SIZE ? Offset + ENTRY_POINT_SEGMENT_SIZE : View->Size;
+        } else if (Info.Format != SmbiosEntryPoint30)
+        {
+            continue;
+        }
+        Found = Info;
+        TableOffset = Table;
+        if (Found.Format == SmbiosEntryPoint30)
+        {
+            break;
+        }
+    }
+    if (TableOffset == View->Size)
+    {
+        puts("No SMBIOS entry point with its table found in image");
+        UnmapSmbiosTableData(View);
+        return false;
+    }
+    SetEntryPointHeader(&Found, &Header);
+    SetTableView(View, &Header, AddPtr(View->Base, TableOffset), View->Size - TableOffset);
+    return true;
+}
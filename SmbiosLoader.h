@@ -0,0 +1,141 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+
+/* Read the whole table into a new buffer with SMBIOS_RAW_DATA header, free with free() */
+bool
+GetSmbiosTableData(
+    PSMBIOS_RAW_DATA* Data);
+
+typedef enum _SMBIOS_ENTRY_POINT_FORMAT
+{
+    SmbiosEntryPointLegacy,         // "_DMI_" alone, legacy DMI BIOS without SMBIOS entry point
+    SmbiosEntryPoint21,             // "_SM_" with "_DMI_" intermediate part, 32-bit table address
+    SmbiosEntryPoint30,             // "_SM3_", 64-bit table address
+} SMBIOS_ENTRY_POINT_FORMAT, *PSMBIOS_ENTRY_POINT_FORMAT;
+
+/* Entry point of any format, fields the format does not have are 0 */
+typedef struct _SMBIOS_ENTRY_POINT_INFO
+{
+    BYTE Format;                    // SMBIOS_ENTRY_POINT_FORMAT
+    BYTE Length;                    // Entry point length
+    BYTE MajorVersion;              // From BCD revision for legacy entry points
+    BYTE MinorVersion;
+    DWORD TableLength;              // Structure table length, or maximum size for 3.0
+    QWORD TableAddress;
+    WORD MaxStructureSize;          // 2.1 only
+    WORD NumberOfStructures;        // 2.1 and legacy only
+} SMBIOS_ENTRY_POINT_INFO, *PSMBIOS_ENTRY_POINT_INFO;
+
+/*
+ * Parse the entry point at start of Buffer, returns false unless its anchors, length and checksums (both of
+ * a 2.1 entry point) are valid, so nothing in a corrupt one (e.g. table length) is trusted.
+ */
+bool
+SmbiosParseEntryPoint(
+    const void* Buffer,
+    size_t Size,
+    PSMBIOS_ENTRY_POINT_INFO Info);
+
+/* Fill SMBIOS_RAW_DATA header fields (except Used20CallingMethod) from a valid entry point structure */
+bool
+ParseSmbiosEntryPoint(
+    const void* Buffer,
+    size_t Size,
+    PSMBIOS_RAW_DATA Header);
+
+/*
+ * Table data without copying, header fields are the same as SMBIOS_RAW_DATA but kept apart from the table,
+ * so the table can be mapped from file directly.
+ */
+typedef struct _SMBIOS_TABLE_VIEW
+{
+    BYTE Used20CallingMethod;
+    BYTE SMBIOSMajorVersion;
+    BYTE SMBIOSMinorVersion;
+    BYTE DmiRevision;
+    DWORD Length;
+    const BYTE* SMBIOSTableData;    // _Field_size_bytes_(Length)
+    bool Partial;                   // Only some structures of the table, offsets in it are not the firmware's
+
+    /* Private */
+    void* Base;
+    size_t Size;
+    bool Mapped;
+} SMBIOS_TABLE_VIEW, *PSMBIOS_TABLE_VIEW;
+
+/* Live table of current system, mapped if the firmware interface supports, otherwise read once */
+bool
+MapSmbiosTableData(
+    PSMBIOS_TABLE_VIEW View);
+
+/*
+ * Live table with only structures of the types selected, read one by one from /sys/firmware/dmi/entries on Linux,
+ * grouped by type in instance order. The view is Partial as offsets are within it and not the firmware table.
+ * Reads the whole table instead if the system has no such entries, or none of the types.
+ */
+bool
+MapSmbiosTableTypes(
+    const bool Types[UCHAR_MAX + 1],
+    PSMBIOS_TABLE_VIEW View);
+
+/* Table dump (e.g. copy of /sys/firmware/dmi/tables/DMI) with optional entry point dump */
+bool
+MapSmbiosTableFile(
+    const char* TablePath,
+    const char* EntryPointPath,
+    PSMBIOS_TABLE_VIEW View);
+
+/* Table built in memory (e.g. by SmbiosGenerateTable), the view takes Data and frees it on unmap */
+void
+AttachSmbiosTableData(
+    PSMBIOS_RAW_DATA Data,
+    PSMBIOS_TABLE_VIEW View);
+
+void
+UnmapSmbiosTableData(
+    PSMBIOS_TABLE_VIEW View);
+
+/*
+ * Self-describing dump file, same layout as "dmidecode --dump-bin": an entry point at offset 0 whose table address
+ * is the file offset of the table, and the table at offset SMBIOS_DUMP_TABLE_OFFSET.
+ */
+#define SMBIOS_DUMP_TABLE_OFFSET 0x20
+
+/* Write a dump, the entry point is made up from view header (_SM3_ for 3.x or large tables, _SM_ otherwise) */
+bool
+SaveSmbiosTableDump(
+    const char* Path,
+    const SMBIOS_TABLE_VIEW* View);
+
+/* Map a dump written by SaveSmbiosTableDump or dmidecode, a file without entry point is taken as a bare table */
+bool
+MapSmbiosTableDump(
+    const char* Path,
+    PSMBIOS_TABLE_VIEW View);
+
+/*
+ * Search Buffer from Offset on 16-byte boundaries for a valid entry point, returns its offset, or Size if none.
+ * Anchors are found with vector compares, so searching costs about as much as reading the buffer.
+ */
+size_t
+SmbiosFindEntryPoint(
+    const void* Buffer,
+    size_t Size,
+    size_t Offset,
+    PSMBIOS_ENTRY_POINT_INFO Info);
+
+/*
+ * Map a raw image of firmware or memory (e.g. legacy BIOS region dump or VM memory snapshot) and find the table by
+ * the first entry point whose table is in the image, preferring a 3.0 one in the same 64 KiB segment.
+ * BaseAddress is the physical address of the image start, table address minus it is the table offset in the file.
+ */
+bool
+MapSmbiosTableImage(
+    const char* Path,
+    QWORD BaseAddress,
+    PSMBIOS_TABLE_VIEW View);
@@ -0,0 +1,187 @@
+﻿#include "SmbiosPlan.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MASK_OF_BITS(Bits) ((Bits) >= 64 ? ~(QWORD)0 : ((QWORD)1 << (Bits)) - 1)
+
+/* Returns number of steps, fields from an irregular bit field on are dropped as the decoder never reached them */
+static
+WORD
+CompilePlan(
+    PSMBIOS_TYPE_INFO TypeInfo,
+    PSMBIOS_DECODE_STEP Steps)
+{
+    PSMBIOS_FIELD_TYPE_INFO Field, Parent = NULL;
+    PSMBIOS_DECODE_STEP Step;
+    WORD i, MinLength, RequiredLength = 0;
+
+    for (i = 0; i < TypeInfo->FieldCount; i++)
+    {
+        Field = &TypeInfo->Fields[i];
+        Step = &Steps[i];
+        memset(Step, 0, sizeof(*Step));
+        Step->Field = Field;
+
+        if (Field->IsBitField)
+        {
+            /* Bit fields belong to the integer field right before the first of them */
+            if (Parent == NULL)
+            {
+                if (i == 0 ||
+                    TypeInfo->Fields[i - 1].IsBitField ||
+                    TypeInfo->Fields[i - 1].Type != SmbiosDataTypeUInt ||
+                    TypeInfo->Fields[i - 1].Size > sizeof(QWORD))
+                {
+                    break;
+                }
+                Parent = &TypeInfo->Fields[i - 1];
+                Step->Flags |= SMBIOS_DECODE_STEP_LOAD;
+            }
+            Step->DataOffset = Parent->Offset;
+            Step->DataSize = Parent->Size;
+            Step->Shift = (BYTE)Field->Offset;
+            Step->Mask = MASK_OF_BITS(Field->Size);
+            MinLength = Parent->Offset + Parent->Size;
+        } else
+        {
+            Parent = NULL;
+            Step->DataOffset = Field->Offset;
+            Step->DataSize = Field->Size;
+            if (((Field->Type == SmbiosDataTypeUInt || Field->Type == SmbiosDataTypeEnum) && Field->Size <= sizeof(QWORD)) ||
+                (Field->Type == SmbiosDataTypeString && Field->Size == sizeof(BYTE)))
+            {
+                Step->Flags |= SMBIOS_DECODE_STEP_LOAD;
+                Step->Mask = MASK_OF_BITS(Field->Size * 8);
+            }
+            MinLength = Field->Offset + Field->Size;
+        }
+
+        if (Field->Type == SmbiosDataTypeString)
+        {
+            Step->Kind = SmbiosDecodeStepString;
+            if (!Field->IsBitField && Field->Size == sizeof(BYTE))
+            {
+                Step->Flags |= SMBIOS_DECODE_STEP_STRING;
+            }
+        } else if (Field->Type == SmbiosDataTypeBit)
+        {
+            Step->Kind = SmbiosDecodeStepBit;
+        } else
+        {
+            Step->Kind = SmbiosDecodeStepField;
+            if (Field->Type == SmbiosDataTypeEnum)
+            {
+                Step->Flags |= SMBIOS_DECODE_STEP_ENUM;
+            }
+        }
+
+        /* A field out of the structure ends decoding, so it hides all fields after it */
+        if (RequiredLength < MinLength)
+        {
+            RequiredLength = MinLength;
+        }
+        Step->RequiredLength = RequiredLength;
+    }
+    return i;
+}
+
+bool
+SmbiosCompileDecodePlans(
+    PSMBIOS_DECODE_PLANS Plans)
+{
+    size_t Count;
+    unsigned int Type;
+    PSMBIOS_TYPE_INFO TypeInfo;
+
+    memset(Plans, 0, sizeof(*Plans));
+    Count = 0;
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        if (SmbiosTypeInfoByType[Type] != NULL)
+        {
+            Count += SmbiosTypeInfoByType[Type]->FieldCount;
+        }
+    }
+    Plans->Steps = (PSMBIOS_DECODE_STEP)malloc((Count != 0 ? Count : 1) * sizeof(SMBIOS_DECODE_STEP));
+    if (Plans->Steps == NULL)
+    {
+        return false;
+    }
+
+    Count = 0;
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        TypeInfo = SmbiosTypeInfoByType[Type];
+        if (TypeInfo == NULL)
+        {
+            continue;
+        }
+        Plans->ByType[Type].TypeInfo = TypeInfo;
+        Plans->ByType[Type].Steps = &Plans->Steps[Count];
+        Plans->ByType[Type].StepCount = CompilePlan(TypeInfo, &Plans->Steps[Count]);
+        Count += TypeInfo->FieldCount;
+    }
+    return true;
+}
+
+void
+SmbiosFreeDecodePlans(
+    PSMBIOS_DECODE_PLANS Plans)
+{
+    free(Plans->Steps);
+    memset(Plans, 0, sizeof(*Plans));
+}
+
+WORD
+SmbiosDecodePlanStepCount(
+    const SMBIOS_DECODE_PLAN* Plan,
+    BYTE Length)
+{
+    WORD Low, High, Middle;
+
+    Low = 0;
+    High = Plan->StepCount;
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+        if (Plan->Steps[Middle].RequiredLength <= Length)
+        {
+            Low = Middle + 1;
+        } else
+        {
+            High = Middle;
+        }
+    }
+    return Low;
+}
+
+void
+SmbiosFilterDecodePlan(
+    PSMBIOS_DECODE_PLAN Plan,
+    PSMBIOS_DECODE_STEP Steps,
+    const SMBIOS_DECODE_PLAN* Source,
+    const bool* Selected)
+{
+    WORD i, Count = 0;
+
+    for (i = 0; i < Source->StepCount; i++)
+    {
+        if (!Selected[i])
+        {
+            continue;
+        }
+        Steps[Count] = Source->Steps[i];
+
+        /* Bit fields reuse the integer loaded by previous step, which may be dropped */
+        if (Steps[Count].Field->IsBitField && !Selected[i - 1])
+        {
+            Steps[Count].Flags |= SMBIOS_DECODE_STEP_LOAD;
+        }
+        Count++;
+    }
+    Plan->TypeInfo = Source->TypeInfo;
+    Plan->Steps = Steps;
+    Plan->StepCount = Count;
+    Plan->Partial = true;
+}
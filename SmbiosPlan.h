@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+#include "SMBIOS.TypeInfo.h"
+
+#include <stdbool.h>
+#include <limits.h>
+
+typedef enum _SMBIOS_DECODE_STEP_KIND
+{
+    SmbiosDecodeStepField,          // Integer, enumeration, UUID and raw fields, including multi-bit fields
+    SmbiosDecodeStepString,
+    SmbiosDecodeStepBit,
+    SmbiosDecodeStepKindCount
+} SMBIOS_DECODE_STEP_KIND, *PSMBIOS_DECODE_STEP_KIND;
+
+#define SMBIOS_DECODE_STEP_LOAD     0x01    // Load DataSize bytes at DataOffset, otherwise reuse the last loaded integer
+#define SMBIOS_DECODE_STEP_ENUM     0x02    // Look up enumeration name of value
+#define SMBIOS_DECODE_STEP_STRING   0x04    // Value is a string index to resolve
+
+/*
+ * One field with everything about reading it resolved when compiling, bit fields point to their parent integer.
+ * Value = (Integer >> Shift) & Mask, Mask is 0 for fields without an integer value.
+ */
+typedef struct _SMBIOS_DECODE_STEP
+{
+    PSMBIOS_FIELD_TYPE_INFO Field;
+    QWORD Mask;
+    WORD RequiredLength;            // Structure length needed by this and all previous steps
+    WORD DataOffset;                // Field, or parent integer of bit field
+    WORD DataSize;
+    BYTE Shift;
+    BYTE Kind;                      // SMBIOS_DECODE_STEP_KIND
+    BYTE Flags;                     // SMBIOS_DECODE_STEP_*
+} SMBIOS_DECODE_STEP, *PSMBIOS_DECODE_STEP;
+
+/* Steps of a type in field order, RequiredLength is non-decreasing so steps to run are a prefix */
+typedef struct _SMBIOS_DECODE_PLAN
+{
+    PSMBIOS_TYPE_INFO TypeInfo;
+    PSMBIOS_DECODE_STEP Steps;      // _Field_size_(StepCount)
+    WORD StepCount;
+    bool Partial;                   // Only some fields of the type, see SmbiosFilterDecodePlan
+} SMBIOS_DECODE_PLAN, *PSMBIOS_DECODE_PLAN;
+
+/*
+ * Plans of all known types, read-only after compiled so can be shared by decode contexts of any thread.
+ * Types with a generated visit function (SMBIOS.TypeDecode.h) take it instead of interpreting the plan,
+ * unless InterpretOnly is set.
+ */
+typedef struct _SMBIOS_DECODE_PLANS
+{
+    SMBIOS_DECODE_PLAN ByType[UCHAR_MAX + 1];
+    PSMBIOS_DECODE_STEP Steps;
+    bool InterpretOnly;
+} SMBIOS_DECODE_PLANS, *PSMBIOS_DECODE_PLANS;
+
+bool
+SmbiosCompileDecodePlans(
+    PSMBIOS_DECODE_PLANS Plans);
+
+void
+SmbiosFreeDecodePlans(
+    PSMBIOS_DECODE_PLANS Plans);
+
+/* Number of steps to run for a structure of Length bytes */
+WORD
+SmbiosDecodePlanStepCount(
+    const SMBIOS_DECODE_PLAN* Plan,
+    BYTE Length);
+
+/*
+ * Make Plan from the steps of Source selected by Selected[step index], into Steps which has room for all steps
+ * of Source. Fields are visited as if decoding the whole structure, so a field hidden by an earlier field out of
+ * the structure stays hidden. The result is partial and is always interpreted.
+ */
+void
+SmbiosFilterDecodePlan(
+    PSMBIOS_DECODE_PLAN Plan,
+    PSMBIOS_DECODE_STEP Steps,
+    const SMBIOS_DECODE_PLAN* Source,
+    const bool* Selected);
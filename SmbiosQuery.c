@@ -0,0 +1,343 @@
+﻿#include "SmbiosQuery.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Types the specification allows only one structure of */
+static
+bool
+IsSingleInstanceType(
+    BYTE Type)
+{
+    return Type == 0 || Type == 1 || Type == 32 || Type == 127;
+}
+
+/* Compare names on letters and digits only, ignoring case */
+static
+bool
+IsSameFieldName(
+    const char* Name,
+    const char* Pattern)
+{
+    for (;;)
+    {
+        while (*Name != '\0' && !isalnum((unsigned char)*Name))
+        {
+            Name++;
+        }
+        while (*Pattern != '\0' && !isalnum((unsigned char)*Pattern))
+        {
+            Pattern++;
+        }
+        if (*Name == '\0' || *Pattern == '\0')
+        {
+            return *Name == *Pattern;
+        }
+        if (tolower((unsigned char)*Name) != tolower((unsigned char)*Pattern))
+        {
+            return false;
+        }
+        Name++;
+        Pattern++;
+    }
+}
+
+static
+bool
+IsFieldSelected(
+    const SMBIOS_QUERY* Query,
+    BYTE Type,
+    PSMBIOS_FIELD_TYPE_INFO Field)
+{
+    size_t i;
+
+    for (i = 0; i < Query->Count; i++)
+    {
+        if (Query->Terms[i].Kind == SmbiosQueryField &&
+            Query->Terms[i].Type == Type &&
+            IsSameFieldName(Field->Name, Query->Terms[i].FieldName))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static
+bool
+IsTermMatched(
+    const SMBIOS_QUERY_TERM* Term,
+    PSMBIOS_TABLE Table)
+{
+    if (Term->Kind == SmbiosQueryHandle)
+    {
+        return Term->Handle == Table->Header.Handle;
+    }
+    return Term->Type == Table->Header.Type;
+}
+
+static
+PSMBIOS_QUERY_TERM
+AddTerm(
+    PSMBIOS_QUERY Query,
+    SMBIOS_QUERY_TERM_KIND Kind)
+{
+    PSMBIOS_QUERY_TERM Term;
+
+    if (Query->Count >= SMBIOS_QUERY_MAX_TERMS)
+    {
+        return NULL;
+    }
+    Term = &Query->Terms[Query->Count++];
+    memset(Term, 0, sizeof(*Term));
+    Term->Kind = (BYTE)Kind;
+    return Term;
+}
+
+bool
+SmbiosAddQueryType(
+    PSMBIOS_QUERY Query,
+    BYTE Type)
+{
+    PSMBIOS_QUERY_TERM Term;
+
+    Term = AddTerm(Query, SmbiosQueryType);
+    if (Term == NULL)
+    {
+        return false;
+    }
+    Term->Type = Type;
+    return true;
+}
+
+bool
+SmbiosAddQueryHandle(
+    PSMBIOS_QUERY Query,
+    WORD Handle)
+{
+    PSMBIOS_QUERY_TERM Term;
+
+    Term = AddTerm(Query, SmbiosQueryHandle);
+    if (Term == NULL)
+    {
+        return false;
+    }
+    Term->Handle = Handle;
+    return true;
+}
+
+bool
+SmbiosAddQueryField(
+    PSMBIOS_QUERY Query,
+    const char* Path)
+{
+    PSMBIOS_QUERY_TERM Term;
+    PSMBIOS_TYPE_INFO TypeInfo;
+    unsigned long Type;
+    char* Name;
+    WORD i;
+
+    Type = strtoul(Path, &Name, 10);
+    if (Name == Path || *Name != '.' || Type > UCHAR_MAX)
+    {
+        return false;
+    }
+    Name++;
+    TypeInfo = SmbiosTypeInfoByType[Type];
+    if (TypeInfo == NULL)
+    {
+        return false;
+    }
+    for (i = 0; i < TypeInfo->FieldCount; i++)
+    {
+        if (IsSameFieldName(TypeInfo->Fields[i].Name, Name))
+        {
+            break;
+        }
+    }
+    if (i == TypeInfo->FieldCount)
+    {
+        return false;
+    }
+
+    Term = AddTerm(Query, SmbiosQueryField);
+    if (Term == NULL)
+    {
+        return false;
+    }
+    Term->Type = (BYTE)Type;
+    Term->FieldName = Name;
+    return true;
+}
+
+bool
+SmbiosCompileQuery(
+    PSMBIOS_QUERY Query,
+    const SMBIOS_DECODE_PLANS* Plans)
+{
+    const SMBIOS_DECODE_PLAN* Source;
+    bool* Selected;
+    bool ParentSelected = false;
+    size_t i, Count;
+    unsigned int Type;
+    WORD Step;
+
+    memset(Query->Selection, SmbiosQuerySelectNone, sizeof(Query->Selection));
+    memset(Query->Plans, 0, sizeof(Query->Plans));
+    Query->Steps = NULL;
+    Query->Unique = true;
+    for (i = 0; i < Query->Count; i++)
+    {
+        if (Query->Terms[i].Kind == SmbiosQueryType)
+        {
+            Query->Selection[Query->Terms[i].Type] = SmbiosQuerySelectAll;
+        } else if (Query->Terms[i].Kind == SmbiosQueryField &&
+                   Query->Selection[Query->Terms[i].Type] == SmbiosQuerySelectNone)
+        {
+            Query->Selection[Query->Terms[i].Type] = SmbiosQuerySelectFields;
+        }
+        if (Query->Terms[i].Kind != SmbiosQueryHandle && !IsSingleInstanceType(Query->Terms[i].Type))
+        {
+            Query->Unique = false;
+        }
+    }
+
+    Count = 0;
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        if (Query->Selection[Type] == SmbiosQuerySelectFields)
+        {
+            Count += Plans->ByType[Type].StepCount;
+        }
+    }
+    Query->Steps = (PSMBIOS_DECODE_STEP)malloc((Count != 0 ? Count : 1) * sizeof(SMBIOS_DECODE_STEP));
+    Selected = (bool*)malloc(Count != 0 ? Count : 1);
+    if (Query->Steps == NULL || Selected == NULL)
+    {
+        free(Selected);
+        SmbiosFreeQuery(Query);
+        return false;
+    }
+
+    /* Select steps by field names, bit fields follow their parent integer */
+    Count = 0;
+    for (Type = 0; Type <= UCHAR_MAX; Type++)
+    {
+        if (Query->Selection[Type] != SmbiosQuerySelectFields)
+        {
+            continue;
+        }
+        Source = &Plans->ByType[Type];
+        for (Step = 0; Step < Source->StepCount; Step++)
+        {
+            Selected[Step] = IsFieldSelected(Query, (BYTE)Type, Source->Steps[Step].Field);
+            if (!Source->Steps[Step].Field->IsBitField)
+            {
+                ParentSelected = Selected[Step];
+            } else if (ParentSelected)
+            {
+                Selected[Step] = true;
+            }
+        }
+        SmbiosFilterDecodePlan(&Query->Plans[Type], &Query->Steps[Count], Source, Selected);
+        Count += Query->Plans[Type].StepCount;
+    }
+    free(Selected);
+    return true;
+}
+
+void
+SmbiosFreeQuery(
+    PSMBIOS_QUERY Query)
+{
+    free(Query->Steps);
+    Query->Steps = NULL;
+    memset(Query->Plans, 0, sizeof(Query->Plans));
+}
+
+bool
+SmbiosGetQueryTypes(
+    const SMBIOS_QUERY* Query,
+    bool Types[UCHAR_MAX + 1])
+{
+    size_t i;
+
+    memset(Types, 0, (UCHAR_MAX + 1) * sizeof(bool));
+    for (i = 0; i < Query->Count; i++)
+    {
+        if (Query->Terms[i].Kind == SmbiosQueryHandle)
+        {
+            return false;
+        }
+        Types[Query->Terms[i].Type] = true;
+    }
+    return Query->Count != 0;
+}
+
+SMBIOS_VISIT_ACTION
+SmbiosQueryStructure(
+    const SMBIOS_QUERY* Query,
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_VISITOR* Visitor)
+{
+    PSMBIOS_TABLE Table = Context->Table;
+    BYTE Selection;
+    size_t i;
+
+    Selection = Query->Selection[Table->Header.Type];
+    for (i = 0; Selection != SmbiosQuerySelectAll && i < Query->Count; i++)
+    {
+        if (Query->Terms[i].Kind == SmbiosQueryHandle && Query->Terms[i].Handle == Table->Header.Handle)
+        {
+            Selection = SmbiosQuerySelectAll;
+        }
+    }
+    if (Selection == SmbiosQuerySelectNone)
+    {
+        return SmbiosVisitSkip;
+    }
+
+    /* Only the selected fields, context is back to the full plan on next structure */
+    if (Selection == SmbiosQuerySelectFields && Context->Plan != NULL)
+    {
+        Context->Plan = &Query->Plans[Table->Header.Type];
+    }
+    return SmbiosVisitStructure(Context, Visitor);
+}
+
+bool
+SmbiosQueryTable(
+    const SMBIOS_QUERY* Query,
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_VISITOR* Visitor)
+{
+    QWORD Matched = 0, AllMatched;
+    size_t i;
+
+    AllMatched = Query->Count >= SMBIOS_QUERY_MAX_TERMS ? ~(QWORD)0 : ((QWORD)1 << Query->Count) - 1;
+    while (SmbiosNextStructure(Context))
+    {
+        if (SmbiosQueryStructure(Query, Context, Visitor) == SmbiosVisitStop)
+        {
+            return false;
+        }
+
+        /* No need to walk the rest once every term has got its only structure */
+        if (Query->Unique)
+        {
+            for (i = 0; i < Query->Count; i++)
+            {
+                if (IsTermMatched(&Query->Terms[i], Context->Table))
+                {
+                    Matched |= (QWORD)1 << i;
+                }
+            }
+            if (Matched == AllMatched)
+            {
+                break;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+﻿#pragma once
+
+#include "SmbiosPlan.h"
+#include "SmbiosVisit.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+
+#define SMBIOS_QUERY_MAX_TERMS 64       // Matched terms are tracked in a QWORD
+
+typedef enum _SMBIOS_QUERY_TERM_KIND
+{
+    SmbiosQueryType,                // All fields of structures of a type
+    SmbiosQueryHandle,              // All fields of the structure with a handle
+    SmbiosQueryField,               // Some fields of structures of a type
+} SMBIOS_QUERY_TERM_KIND, *PSMBIOS_QUERY_TERM_KIND;
+
+typedef struct _SMBIOS_QUERY_TERM
+{
+    BYTE Kind;                      // SMBIOS_QUERY_TERM_KIND
+    BYTE Type;                      // SmbiosQueryType and SmbiosQueryField
+    WORD Handle;                    // SmbiosQueryHandle
+    const char* FieldName;          // SmbiosQueryField, not copied
+} SMBIOS_QUERY_TERM, *PSMBIOS_QUERY_TERM;
+
+typedef enum _SMBIOS_QUERY_SELECTION
+{
+    SmbiosQuerySelectNone,
+    SmbiosQuerySelectFields,
+    SmbiosQuerySelectAll,
+} SMBIOS_QUERY_SELECTION, *PSMBIOS_QUERY_SELECTION;
+
+/*
+ * Select structures and fields to decode, a structure is visited if any term matches it, with fields of all
+ * matching terms. Field names match ignoring case and anything but letters and digits, so "1.Serial Number" and
+ * "1.serialnumber" are the same, an integer field brings its bit fields too.
+ *
+ * When every term can match only one structure (a handle, or a type the specification allows one structure of,
+ * such as 0, 1 and 32), the walk stops after all of them matched.
+ *
+ * Zero initialize before adding terms, read-only after compiled so can be shared by decode contexts of any thread.
+ */
+typedef struct _SMBIOS_QUERY
+{
+    SMBIOS_QUERY_TERM Terms[SMBIOS_QUERY_MAX_TERMS]; // _Field_size_(Count)
+    size_t Count;
+
+    /* Private, built by SmbiosCompileQuery */
+    BYTE Selection[UCHAR_MAX + 1];  // SMBIOS_QUERY_SELECTION of types
+    SMBIOS_DECODE_PLAN Plans[UCHAR_MAX + 1]; // Partial plans of types selected by fields
+    PSMBIOS_DECODE_STEP Steps;
+    bool Unique;
+} SMBIOS_QUERY, *PSMBIOS_QUERY;
+
+bool
+SmbiosAddQueryType(
+    PSMBIOS_QUERY Query,
+    BYTE Type);
+
+bool
+SmbiosAddQueryHandle(
+    PSMBIOS_QUERY Query,
+    WORD Handle);
+
+/* Path is "<type>.<field name>" and kept by the query, returns false if the type has no such field */
+bool
+SmbiosAddQueryField(
+    PSMBIOS_QUERY Query,
+    const char* Path);
+
+/* Build partial plans from Plans, which must be the plans of decode contexts the query is used with */
+bool
+SmbiosCompileQuery(
+    PSMBIOS_QUERY Query,
+    const SMBIOS_DECODE_PLANS* Plans);
+
+void
+SmbiosFreeQuery(
+    PSMBIOS_QUERY Query);
+
+/* Types of structures the query could select, false if it could select any (e.g. by handle) or has no terms */
+bool
+SmbiosGetQueryTypes(
+    const SMBIOS_QUERY* Query,
+    bool Types[UCHAR_MAX + 1]);
+
+/* Visit current structure of context if the query selects it, returns SmbiosVisitSkip if not */
+SMBIOS_VISIT_ACTION
+SmbiosQueryStructure(
+    const SMBIOS_QUERY* Query,
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_VISITOR* Visitor);
+
+/* Like SmbiosVisitTable but only visit what the query selected, returns false if stopped by visitor */
+bool
+SmbiosQueryTable(
+    const SMBIOS_QUERY* Query,
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_VISITOR* Visitor);
@@ -0,0 +1,527 @@
+﻿#include "SmbiosTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SMBIOS_SCAN_X86
+#include "CPUID.h"
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define SCAN_TARGET(x) __attribute__((target(x)))
+#else
+#define SCAN_TARGET(x)
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static unsigned int CountTrailingZeros(QWORD x)
+{
+    unsigned long i;
+#if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanForward64(&i, x);
+#else
+    if (!_BitScanForward(&i, (unsigned long)x))
+    {
+        _BitScanForward(&i, (unsigned long)(x >> 32));
+        i += 32;
+    }
+#endif
+    return i;
+}
+#else
+#define CountTrailingZeros(x) ((unsigned int)__builtin_ctzll(x))
+#endif
+
+#define BITMAP_WORDS(Length) (((Length) + 63) / 64 + 1)
+
+#pragma region Stage 1: NUL bitmap
+
+static
+void
+ScanNulScalar(
+    const BYTE* Data,
+    DWORD Length,
+    QWORD* Bitmap)
+{
+    DWORD i;
+
+    for (i = 0; i < Length; i++)
+    {
+        if (Data[i] == 0)
+        {
+            Bitmap[i / 64] |= (QWORD)1 << (i % 64);
+        }
+    }
+}
+
+#ifdef SMBIOS_SCAN_X86
+
+static
+SCAN_TARGET("sse2")
+void
+ScanNulSse2(
+    const BYTE* Data,
+    DWORD Length,
+    QWORD* Bitmap)
+{
+    __m128i Zero = _mm_setzero_si128();
+    QWORD m0, m1, m2, m3;
+    DWORD i;
+
+    for (i = 0; i + 64 <= Length; i += 64)
+    {
+        m0 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Data + i)), Zero));
+        m1 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Data + i + 16)), Zero));
+        m2 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Data + i + 32)), Zero));
+        m3 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Data + i + 48)), Zero));
+        Bitmap[i / 64] = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+    }
+    ScanNulScalar(Data + i, Length - i, Bitmap + i / 64);
+}
+
+static
+SCAN_TARGET("avx2")
+void
+ScanNulAvx2(
+    const BYTE* Data,
+    DWORD Length,
+    QWORD* Bitmap)
+{
+    __m256i Zero = _mm256_setzero_si256();
+    QWORD m0, m1;
+    DWORD i;
+
+    for (i = 0; i + 64 <= Length; i += 64)
+    {
+        m0 = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Data + i)), Zero));
+        m1 = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Data + i + 32)), Zero));
+        Bitmap[i / 64] = m0 | (m1 << 32);
+    }
+    ScanNulScalar(Data + i, Length - i, Bitmap + i / 64);
+}
+
+static
+SCAN_TARGET("avx512f,avx512bw")
+void
+ScanNulAvx512(
+    const BYTE* Data,
+    DWORD Length,
+    QWORD* Bitmap)
+{
+    __m512i Zero = _mm512_setzero_si512();
+    DWORD i;
+
+    for (i = 0; i + 64 <= Length; i += 64)
+    {
+        Bitmap[i / 64] = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)(Data + i)), Zero);
+    }
+    ScanNulScalar(Data + i, Length - i, Bitmap + i / 64);
+}
+
+static
+void
+ReadCpuid(
+    PCPUID_INFO Info,
+    unsigned int Leaf,
+    unsigned int SubLeaf)
+{
+#if defined(_MSC_VER)
+    __cpuidex(Info->Registers, Leaf, SubLeaf);
+#else
+    __cpuid_count(Leaf, SubLeaf, Info->Eax, Info->Ebx, Info->Ecx, Info->Edx);
+#endif
+}
+
+static
+QWORD
+ReadXcr0(void)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int Eax, Edx;
+    __asm__ __volatile__("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+    return ((QWORD)Edx << 32) | Eax;
+#endif
+}
+
+typedef enum _SCAN_LEVEL
+{
+    ScanLevelScalar,
+    ScanLevelSse2,
+    ScanLevelAvx2,
+    ScanLevelAvx512,
+} SCAN_LEVEL, *PSCAN_LEVEL;
+
+/* Widest vector instructions both the processor and the OS support */
+static
+SCAN_LEVEL
+SelectScanLevel(void)
+{
+    CPUID_INFO Info;
+    unsigned int MaxLeaf;
+    QWORD Xcr0;
+    bool Sse2, OsAvx, OsAvx512;
+
+    ReadCpuid(&Info, 0, 0);
+    MaxLeaf = Info.F00_00.MaxInputValue;
+    ReadCpuid(&Info, 1, 0);
+    Sse2 = Info.F01_00.FeatureInfo.SSE2;
+    OsAvx = OsAvx512 = false;
+    if (Info.F01_00.FeatureInfo.OSXSAVE)
+    {
+        /* XMM | YMM state, and opmask | ZMM_Hi256 | Hi16_ZMM state */
+        Xcr0 = ReadXcr0();
+        OsAvx = (Xcr0 & 0x6) == 0x6;
+        OsAvx512 = OsAvx && (Xcr0 & 0xE0) == 0xE0;
+    }
+    if (MaxLeaf >= 7)
+    {
+        ReadCpuid(&Info, 7, 0);
+        if (OsAvx512 && Info.F07_00.FeatureFlags.AVX512F && Info.F07_00.FeatureFlags.AVX512BW)
+        {
+            return ScanLevelAvx512;
+        }
+        if (OsAvx && Info.F07_00.FeatureFlags.AVX2)
+        {
+            return ScanLevelAvx2;
+        }
+    }
+    return Sse2 ? ScanLevelSse2 : ScanLevelScalar;
+}
+
+static SCAN_LEVEL ScanLevel;
+
+#if defined(_WIN32)
+
+static INIT_ONCE ScanLevelOnce = INIT_ONCE_STATIC_INIT;
+
+static
+BOOL
+CALLBACK
+InitializeScanLevel(
+    PINIT_ONCE InitOnce,
+    PVOID Parameter,
+    PVOID* Context)
+{
+    ScanLevel = SelectScanLevel();
+    return TRUE;
+}
+
+#else
+
+static pthread_once_t ScanLevelOnce = PTHREAD_ONCE_INIT;
+
+static
+void
+InitializeScanLevel(void)
+{
+    ScanLevel = SelectScanLevel();
+}
+
+#endif
+
+/* CPUID is serializing and traps to the hypervisor in a VM, so the level is selected once per process */
+static
+SCAN_LEVEL
+GetScanLevel(void)
+{
+#if defined(_WIN32)
+    InitOnceExecuteOnce(&ScanLevelOnce, InitializeScanLevel, NULL, NULL);
+#else
+    pthread_once(&ScanLevelOnce, InitializeScanLevel);
+#endif
+    return ScanLevel;
+}
+
+typedef void (*SCAN_NUL_ROUTINE)(const BYTE* Data, DWORD Length, QWORD* Bitmap);
+
+static const SCAN_NUL_ROUTINE ScanNulRoutines[] = { ScanNulScalar, ScanNulSse2, ScanNulAvx2, ScanNulAvx512 };
+
+#endif /* SMBIOS_SCAN_X86 */
+
+bool
+SmbiosScanTable(
+    const void* TableData,
+    DWORD Length,
+    PSMBIOS_TABLE_SCAN Scan)
+{
+    Scan->TableData = TableData;
+    Scan->Length = Length;
+    Scan->NulBitmap = (QWORD*)calloc(BITMAP_WORDS(Length), sizeof(QWORD));
+    if (Scan->NulBitmap == NULL)
+    {
+        return false;
+    }
+#ifdef SMBIOS_SCAN_X86
+    ScanNulRoutines[GetScanLevel()]((const BYTE*)TableData, Length, Scan->NulBitmap);
+#else
+    ScanNulScalar((const BYTE*)TableData, Length, Scan->NulBitmap);
+#endif
+    return true;
+}
+
+void
+SmbiosFreeScan(
+    PSMBIOS_TABLE_SCAN Scan)
+{
+    free(Scan->NulBitmap);
+    memset(Scan, 0, sizeof(*Scan));
+}
+
+#pragma endregion
+
+#pragma region Stage 2: Structure boundaries and string starts
+
+/* Bit N set if byte N and N + 1 are both NUL, bitmap has a zero padding word so Word + 1 is always valid */
+#define DOUBLE_NUL_WORD(Bitmap, Word) ((Bitmap)[Word] & (((Bitmap)[Word] >> 1) | ((Bitmap)[(Word) + 1] << 63)))
+
+static
+DWORD
+FindDoubleNul(
+    const SMBIOS_TABLE_SCAN* Scan,
+    DWORD Offset)
+{
+    DWORD Word, Words;
+    QWORD w;
+
+    Words = BITMAP_WORDS(Scan->Length) - 1;
+    Word = Offset / 64;
+    w = DOUBLE_NUL_WORD(Scan->NulBitmap, Word) & (~(QWORD)0 << (Offset % 64));
+    while (w == 0)
+    {
+        if (++Word >= Words)
+        {
+            return Scan->Length;
+        }
+        w = DOUBLE_NUL_WORD(Scan->NulBitmap, Word);
+    }
+    return Word * 64 + CountTrailingZeros(w);
+}
+
+PSMBIOS_TABLE
+SmbiosScanStructure(
+    const SMBIOS_TABLE_SCAN* Scan,
+    PSMBIOS_TABLE Table,
+    const char** Strings,
+    BYTE* StringCount)
+{
+    DWORD Start, End, Word, LastWord;
+    QWORD w;
+    BYTE Count;
+
+    /* Take the scalar walk for malformed header and the unterminated or truncated tail */
+    Start = SubPtr(Scan->TableData, Table) + Table->Header.Length;
+    if (Table->Header.Length < sizeof(SMBIOS_HEADER) || Start + 2 >= Scan->Length)
+    {
+        return SmbiosWalkStructure(Table, AddPtr(Scan->TableData, Scan->Length), Strings, StringCount);
+    }
+    End = FindDoubleNul(Scan, Start);
+    if (End + 2 >= Scan->Length)
+    {
+        return SmbiosWalkStructure(Table, AddPtr(Scan->TableData, Scan->Length), Strings, StringCount);
+    }
+
+    /* Strings start at the string-set and after each NUL before the terminator */
+    Count = 0;
+    if (Start < End)
+    {
+        if (Strings != NULL)
+        {
+            Strings[0] = (const char*)AddPtr(Scan->TableData, Start);
+        }
+        Count = 1;
+        Word = Start / 64;
+        LastWord = (End - 1) / 64;
+        w = Scan->NulBitmap[Word] & (~(QWORD)0 << (Start % 64));
+        while (true)
+        {
+            if (Word == LastWord)
+            {
+                w &= ~(QWORD)0 >> (63 - (End - 1) % 64);
+            }
+            while (w != 0 && Count < SMBIOS_MAX_STRINGS)
+            {
+                if (Strings != NULL)
+                {
+                    Strings[Count] = (const char*)AddPtr(Scan->TableData, Word * 64 + CountTrailingZeros(w) + 1);
+                }
+                Count++;
+                w &= w - 1;
+            }
+            if (Word == LastWord || Count == SMBIOS_MAX_STRINGS)
+            {
+                break;
+            }
+            w = Scan->NulBitmap[++Word];
+        }
+    }
+
+    *StringCount = Count;
+    return (PSMBIOS_TABLE)AddPtr(Scan->TableData, End + 2);
+}
+
+#pragma endregion
+
+#pragma region Entry Point Anchors
+
+/* First 4 bytes of "_SM3_", "_SM_" and "_DMI_" as little-endian DWORDs, every anchor has one of them */
+#define ANCHOR_DWORD(a, b, c, d) ((DWORD)(BYTE)(a) | (DWORD)(BYTE)(b) << 8 | (DWORD)(BYTE)(c) << 16 | (DWORD)(BYTE)(d) << 24)
+#define ANCHOR_SM3 ANCHOR_DWORD('_', 'S', 'M', '3')
+#define ANCHOR_SM ANCHOR_DWORD('_', 'S', 'M', '_')
+#define ANCHOR_DMI ANCHOR_DWORD('_', 'D', 'M', 'I')
+
+#define PARAGRAPH_SIZE 16
+#define AlignParagraph(Offset) (((Offset) + PARAGRAPH_SIZE - 1) & ~(size_t)(PARAGRAPH_SIZE - 1))
+
+static
+size_t
+ScanAnchorScalar(
+    const BYTE* Data,
+    size_t Size,
+    size_t Offset)
+{
+    DWORD Value;
+
+    for (Offset = AlignParagraph(Offset); Offset < Size && Size - Offset >= sizeof(DWORD); Offset += PARAGRAPH_SIZE)
+    {
+        memcpy(&Value, Data + Offset, sizeof(Value));
+        if (Value == ANCHOR_SM3 || Value == ANCHOR_SM || Value == ANCHOR_DMI)
+        {
+            return Offset;
+        }
+    }
+    return Size;
+}
+
+#ifdef SMBIOS_SCAN_X86
+
+typedef size_t (*SCAN_ANCHOR_ROUTINE)(const BYTE* Data, size_t Size, size_t Offset);
+
+/* Byte mask bits of the first DWORD of each paragraph, in the movemask of 64 bytes */
+#define PARAGRAPH_BYTE_MASK 0x0001000100010001ULL
+
+static
+SCAN_TARGET("sse2")
+size_t
+ScanAnchorSse2(
+    const BYTE* Data,
+    size_t Size,
+    size_t Offset)
+{
+    __m128i Sm3 = _mm_set1_epi32((int)ANCHOR_SM3);
+    __m128i Sm = _mm_set1_epi32((int)ANCHOR_SM);
+    __m128i Dmi = _mm_set1_epi32((int)ANCHOR_DMI);
+    __m128i v;
+    QWORD m;
+    int i;
+
+    for (Offset = AlignParagraph(Offset); Offset < Size && Size - Offset >= 64; Offset += 64)
+    {
+        m = 0;
+        for (i = 0; i < 4; i++)
+        {
+            v = _mm_loadu_si128((const __m128i*)(Data + Offset + i * 16));
+            v = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(v, Sm3), _mm_cmpeq_epi32(v, Sm)), _mm_cmpeq_epi32(v, Dmi));
+            m |= (QWORD)(unsigned int)_mm_movemask_epi8(v) << (i * 16);
+        }
+        m &= PARAGRAPH_BYTE_MASK;
+        if (m != 0)
+        {
+            return Offset + CountTrailingZeros(m);
+        }
+    }
+    return ScanAnchorScalar(Data, Size, Offset);
+}
+
+static
+SCAN_TARGET("avx2")
+size_t
+ScanAnchorAvx2(
+    const BYTE* Data,
+    size_t Size,
+    size_t Offset)
+{
+    __m256i Sm3 = _mm256_set1_epi32((int)ANCHOR_SM3);
+    __m256i Sm = _mm256_set1_epi32((int)ANCHOR_SM);
+    __m256i Dmi = _mm256_set1_epi32((int)ANCHOR_DMI);
+    __m256i v0, v1;
+    QWORD m;
+
+    for (Offset = AlignParagraph(Offset); Offset < Size && Size - Offset >= 64; Offset += 64)
+    {
+        v0 = _mm256_loadu_si256((const __m256i*)(Data + Offset));
+        v1 = _mm256_loadu_si256((const __m256i*)(Data + Offset + 32));
+        v0 = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(v0, Sm3), _mm256_cmpeq_epi32(v0, Sm)), _mm256_cmpeq_epi32(v0, Dmi));
+        v1 = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(v1, Sm3), _mm256_cmpeq_epi32(v1, Sm)), _mm256_cmpeq_epi32(v1, Dmi));
+        m = (QWORD)(unsigned int)_mm256_movemask_epi8(v0) | (QWORD)(unsigned int)_mm256_movemask_epi8(v1) << 32;
+        m &= PARAGRAPH_BYTE_MASK;
+        if (m != 0)
+        {
+            return Offset + CountTrailingZeros(m);
+        }
+    }
+    return ScanAnchorScalar(Data, Size, Offset);
+}
+
+/* DWORD mask bits of the first DWORD of each paragraph, in the compare mask of 64 bytes */
+#define PARAGRAPH_DWORD_MASK 0x1111
+
+static
+SCAN_TARGET("avx512f,avx512bw")
+size_t
+ScanAnchorAvx512(
+    const BYTE* Data,
+    size_t Size,
+    size_t Offset)
+{
+    __m512i Sm3 = _mm512_set1_epi32((int)ANCHOR_SM3);
+    __m512i Sm = _mm512_set1_epi32((int)ANCHOR_SM);
+    __m512i Dmi = _mm512_set1_epi32((int)ANCHOR_DMI);
+    __m512i v;
+    unsigned int m;
+
+    for (Offset = AlignParagraph(Offset); Offset < Size && Size - Offset >= 64; Offset += 64)
+    {
+        v = _mm512_loadu_si512((const void*)(Data + Offset));
+        m = _mm512_cmpeq_epi32_mask(v, Sm3) | _mm512_cmpeq_epi32_mask(v, Sm) | _mm512_cmpeq_epi32_mask(v, Dmi);
+        m &= PARAGRAPH_DWORD_MASK;
+        if (m != 0)
+        {
+            return Offset + CountTrailingZeros(m) * sizeof(DWORD);
+        }
+    }
+    return ScanAnchorScalar(Data, Size, Offset);
+}
+
+static const SCAN_ANCHOR_ROUTINE ScanAnchorRoutines[] = { ScanAnchorScalar, ScanAnchorSse2, ScanAnchorAvx2, ScanAnchorAvx512 };
+
+#endif /* SMBIOS_SCAN_X86 */
+
+size_t
+SmbiosScanAnchors(
+    const void* Data,
+    size_t Size,
+    size_t Offset)
+{
+#ifdef SMBIOS_SCAN_X86
+    return ScanAnchorRoutines[GetScanLevel()]((const BYTE*)Data, Size, Offset);
+#else
+    return ScanAnchorScalar((const BYTE*)Data, Size, Offset);
+#endif
+}
+
+#pragma endregion
@@ -0,0 +1,98 @@
+﻿#include "SmbiosStats.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+const char* const SmbiosStageNames[SmbiosStageCount] = {
+    "load",
+    "walk",
+    "decode",
+    "output",
+};
+
+QWORD
+SmbiosGetNanoseconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER Counter, Frequency;
+
+    QueryPerformanceCounter(&Counter);
+    QueryPerformanceFrequency(&Frequency);
+    return (QWORD)(Counter.QuadPart / Frequency.QuadPart * 1000000000ULL +
+                   Counter.QuadPart % Frequency.QuadPart * 1000000000ULL / Frequency.QuadPart);
+#else
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return (QWORD)Time.tv_sec * 1000000000ULL + (QWORD)Time.tv_nsec;
+#endif
+}
+
+QWORD
+SmbiosGetStatsTime(
+    const SMBIOS_STATS* Stats)
+{
+    QWORD Total = 0;
+    int i;
+
+    for (i = 0; i < SmbiosStageCount; i++)
+    {
+        Total += Stats->Nanoseconds[i];
+    }
+    return Total;
+}
+
+void
+SmbiosStartStage(
+    PSMBIOS_STAGE_TIMER Timer,
+    PSMBIOS_STATS Stats)
+{
+    Timer->Stats = Stats;
+    if (Stats != NULL)
+    {
+        Timer->Start = SmbiosGetNanoseconds();
+        Timer->Nested = SmbiosGetStatsTime(Stats);
+    }
+}
+
+void
+SmbiosEndStage(
+    PSMBIOS_STAGE_TIMER Timer,
+    SMBIOS_STATS_STAGE Stage)
+{
+    QWORD Now, Elapsed, Nested;
+
+    if (Timer->Stats == NULL)
+    {
+        return;
+    }
+    Now = SmbiosGetNanoseconds();
+    Elapsed = Now - Timer->Start;
+    Nested = SmbiosGetStatsTime(Timer->Stats) - Timer->Nested;
+    Timer->Stats->Nanoseconds[Stage] += Elapsed > Nested ? Elapsed - Nested : 0;
+    Timer->Start = Now;
+    Timer->Nested = SmbiosGetStatsTime(Timer->Stats);
+}
+
+void
+SmbiosAddStats(
+    PSMBIOS_STATS Total,
+    const SMBIOS_STATS* Stats)
+{
+    int i;
+
+    for (i = 0; i < SmbiosStageCount; i++)
+    {
+        Total->Nanoseconds[i] += Stats->Nanoseconds[i];
+    }
+    Total->BytesRead += Stats->BytesRead;
+    Total->Structures += Stats->Structures;
+    Total->Strings += Stats->Strings;
+    Total->Fields += Stats->Fields;
+    Total->UnknownTypes += Stats->UnknownTypes;
+    Total->TruncatedStructures += Stats->TruncatedStructures;
+    Total->BytesWritten += Stats->BytesWritten;
+}
@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+
+#include <stdbool.h>
+
+typedef enum _SMBIOS_STATS_STAGE
+{
+    SmbiosStageLoad,                // Reading table, e.g. from sysfs or a dump file
+    SmbiosStageWalk,                // Structure boundaries, string-sets and type information lookup
+    SmbiosStageDecode,              // Fields to visitor, including formatting into output buffer
+    SmbiosStageOutput,              // Writing output buffer to file
+    SmbiosStageCount
+} SMBIOS_STATS_STAGE, *PSMBIOS_STATS_STAGE;
+
+/*
+ * Time and counters of decoding, collected by contexts and writers that have it set and added to by
+ * the caller for stages outside the library (e.g. loading). Nothing is timed without it, and it must not be
+ * shared by contexts or writers used in different threads.
+ * Time of a stage does not include time of other stages run inside it, so stages add up to the total.
+ */
+typedef struct _SMBIOS_STATS
+{
+    QWORD Nanoseconds[SmbiosStageCount];
+    QWORD BytesRead;
+    QWORD Structures;
+    QWORD Strings;
+    QWORD Fields;                   // Fields, bits and strings visited
+    QWORD UnknownTypes;             // Structures without type information
+    QWORD TruncatedStructures;      // Formatted area or string-set cut by end of table
+    QWORD BytesWritten;
+} SMBIOS_STATS, *PSMBIOS_STATS;
+
+extern const char* const SmbiosStageNames[SmbiosStageCount];
+
+/* Monotonic clock */
+QWORD
+SmbiosGetNanoseconds(void);
+
+/* Time of all stages */
+QWORD
+SmbiosGetStatsTime(
+    const SMBIOS_STATS* Stats);
+
+/* Time of a stage in progress, time added to other stages meanwhile is not counted in it */
+typedef struct _SMBIOS_STAGE_TIMER
+{
+    PSMBIOS_STATS Stats;            // NULL to do nothing
+    QWORD Start;
+    QWORD Nested;                   // Time of all stages at start
+} SMBIOS_STAGE_TIMER, *PSMBIOS_STAGE_TIMER;
+
+void
+SmbiosStartStage(
+    PSMBIOS_STAGE_TIMER Timer,
+    PSMBIOS_STATS Stats);
+
+/* Add time since start to Stage, and start again for the next stage */
+void
+SmbiosEndStage(
+    PSMBIOS_STAGE_TIMER Timer,
+    SMBIOS_STATS_STAGE Stage);
+
+/* Add counters and time of one to another, e.g. to sum per-thread stats */
+void
+SmbiosAddStats(
+    PSMBIOS_STATS Total,
+    const SMBIOS_STATS* Stats);
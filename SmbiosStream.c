@@ -0,0 +1,230 @@
+﻿#include "SmbiosStream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Offset of the first double NUL at or after Start, or Size if none */
+static
+size_t
+FindDoubleNul(
+    const BYTE* Data,
+    size_t Start,
+    size_t Size)
+{
+    const BYTE* p;
+    size_t i = Start;
+
+    while (i + 1 < Size)
+    {
+        p = (const BYTE*)memchr(Data + i, '\0', Size - 1 - i);
+        if (p == NULL)
+        {
+            break;
+        }
+        i = p - Data;
+        if (Data[i + 1] == '\0')
+        {
+            return i;
+        }
+        i += 2;
+    }
+    return Size;
+}
+
+static
+bool
+Emit(
+    PSMBIOS_STREAM_PARSER Parser,
+    const void* Table,
+    size_t Size)
+{
+    if (Size > Parser->MaxStructureSize || Size > (DWORD)~0 - Parser->Offset)
+    {
+        Parser->Failed = true;
+        return false;
+    }
+    if (!Parser->Routine(Parser->UserData, (PSMBIOS_TABLE)Table, Parser->Offset, (DWORD)Size))
+    {
+        Parser->Failed = true;
+        return false;
+    }
+    Parser->Offset += (DWORD)Size;
+    return true;
+}
+
+/* Make room for Size more bytes after the buffered ones */
+static
+bool
+Reserve(
+    PSMBIOS_STREAM_PARSER Parser,
+    size_t Size)
+{
+    size_t NewSize;
+    BYTE* NewBuffer;
+
+    if (Size > Parser->MaxStructureSize - Parser->Used)
+    {
+        Parser->Failed = true;
+        return false;
+    }
+    if (Size > Parser->Size - Parser->Used)
+    {
+        NewSize = Parser->Size != 0 ? Parser->Size * 2 : UCHAR_MAX + 1;
+        if (NewSize < Parser->Used + Size)
+        {
+            NewSize = Parser->Used + Size;
+        }
+        if (NewSize > Parser->MaxStructureSize)
+        {
+            NewSize = Parser->MaxStructureSize;
+        }
+        NewBuffer = (BYTE*)realloc(Parser->Buffer, NewSize);
+        if (NewBuffer == NULL)
+        {
+            Parser->Failed = true;
+            return false;
+        }
+        Parser->Buffer = NewBuffer;
+        Parser->Size = NewSize;
+    }
+    return true;
+}
+
+static
+bool
+Append(
+    PSMBIOS_STREAM_PARSER Parser,
+    const BYTE* Data,
+    size_t Size)
+{
+    if (!Reserve(Parser, Size))
+    {
+        return false;
+    }
+    memcpy(Parser->Buffer + Parser->Used, Data, Size);
+    Parser->Used += Size;
+    return true;
+}
+
+bool
+SmbiosFeedStreamParser(
+    PSMBIOS_STREAM_PARSER Parser,
+    const void* Data,
+    size_t Size)
+{
+    const BYTE* p = (const BYTE*)Data;
+    size_t End, Start, Need;
+    bool Complete;
+
+    if (Parser->Failed)
+    {
+        return false;
+    }
+    if (Parser->MaxStructureSize == 0)
+    {
+        Parser->MaxStructureSize = SMBIOS_STREAM_MAX_STRUCTURE_SIZE;
+    }
+    if (Parser->Length != 0 && Size > Parser->Length - Parser->Offset - Parser->Used)
+    {
+        Size = Parser->Length - Parser->Offset - Parser->Used;
+    }
+
+    while (Size != 0)
+    {
+        /* Pass structures complete in this chunk in place, keep the incomplete one at the end */
+        if (Parser->Used == 0)
+        {
+            if (Size < sizeof(SMBIOS_HEADER))
+            {
+                return Append(Parser, p, Size);
+            }
+            if (((PSMBIOS_TABLE)p)->Header.Length < sizeof(SMBIOS_HEADER))
+            {
+                Parser->Failed = true;
+                return false;
+            }
+            End = FindDoubleNul(p, ((PSMBIOS_TABLE)p)->Header.Length, Size);
+            if (End == Size)
+            {
+                return Append(Parser, p, Size);
+            }
+            if (!Emit(Parser, p, End + 2))
+            {
+                return false;
+            }
+            p += End + 2;
+            Size -= End + 2;
+            continue;
+        }
+
+        /* Complete the buffered structure with header, formatted area, then string-set up to the double NUL */
+        Complete = false;
+        if (Parser->Used < sizeof(SMBIOS_HEADER))
+        {
+            Need = sizeof(SMBIOS_HEADER) - Parser->Used;
+        } else if ((Start = ((PSMBIOS_TABLE)Parser->Buffer)->Header.Length) < sizeof(SMBIOS_HEADER))
+        {
+            Parser->Failed = true;
+            return false;
+        } else if (Parser->Used < Start)
+        {
+            Need = Start - Parser->Used;
+        } else if (Parser->Used > Start && Parser->Buffer[Parser->Used - 1] == '\0' && p[0] == '\0')
+        {
+            Need = 1;
+            Complete = true;
+        } else
+        {
+            End = FindDoubleNul(p, 0, Size);
+            Need = End + 2;
+            Complete = End != Size;
+        }
+        if (Need > Size)
+        {
+            Need = Size;
+        }
+        if (!Append(Parser, p, Need))
+        {
+            return false;
+        }
+        p += Need;
+        Size -= Need;
+        if (Complete)
+        {
+            if (!Emit(Parser, Parser->Buffer, Parser->Used))
+            {
+                return false;
+            }
+            Parser->Used = 0;
+        }
+    }
+    return true;
+}
+
+bool
+SmbiosFinishStreamParser(
+    PSMBIOS_STREAM_PARSER Parser)
+{
+    BYTE Length;
+    bool Result;
+
+    Result = !Parser->Failed;
+    if (Result && Parser->Used >= sizeof(SMBIOS_HEADER))
+    {
+        Length = ((PSMBIOS_TABLE)Parser->Buffer)->Header.Length;
+        if (Length < sizeof(SMBIOS_HEADER))
+        {
+            Parser->Failed = true;
+            Result = false;
+        } else
+        {
+            /* Formatted area may be cut by end of stream, decoders take only the part in Size */
+            Result = Emit(Parser, Parser->Buffer, Parser->Used);
+        }
+    }
+    free(Parser->Buffer);
+    Parser->Buffer = NULL;
+    Parser->Size = 0;
+    Parser->Used = 0;
+    return Result;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+#include "SmbiosTable.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SMBIOS_STREAM_MAX_STRUCTURE_SIZE 0x10000
+
+/*
+ * Complete structure, or the tail at end of stream whose formatted area may be shorter than Length.
+ * Table is valid until returns, return false to stop parsing.
+ */
+typedef
+bool
+(*SMBIOS_STREAM_ROUTINE)(
+    void* UserData,
+    PSMBIOS_TABLE Table,
+    DWORD Offset,
+    DWORD Size);
+
+/*
+ * Incremental parser for a table coming in chunks of any size (pipe, socket, decompressor), structures are split
+ * the same way as walking the whole table. Structures complete in a chunk are passed in place, only one
+ * spanning chunks is copied, so memory is bounded by the largest structure instead of the table.
+ *
+ * Zero initialize and fill the public fields, feed all chunks and then finish.
+ */
+typedef struct _SMBIOS_STREAM_PARSER
+{
+    DWORD Length;                   // Table length if known (e.g. from entry point) to ignore bytes after it, or 0
+    size_t MaxStructureSize;        // 0 for SMBIOS_STREAM_MAX_STRUCTURE_SIZE, larger structures fail parsing
+    SMBIOS_STREAM_ROUTINE Routine;
+    void* UserData;
+
+    /* Private */
+    BYTE* Buffer;                   // Incomplete structure // _Field_size_(Size)
+    size_t Size;
+    size_t Used;
+    DWORD Offset;                   // Offset of Buffer in table
+    bool Failed;                    // Length less than header, too large, out of memory, or stopped by Routine
+} SMBIOS_STREAM_PARSER, *PSMBIOS_STREAM_PARSER;
+
+/* Returns false if parsing failed, the rest of the stream should be dropped */
+bool
+SmbiosFeedStreamParser(
+    PSMBIOS_STREAM_PARSER Parser,
+    const void* Data,
+    size_t Size);
+
+/* End of stream, pass the unterminated tail as the last structure like a whole table walk does, and free buffer */
+bool
+SmbiosFinishStreamParser(
+    PSMBIOS_STREAM_PARSER Parser);
@@ -0,0 +1,238 @@
+﻿#include "SmbiosTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+PSMBIOS_TABLE
+SmbiosWalkStructure(
+    PSMBIOS_TABLE Table,
+    const void* EndOfData,
+    const char** Strings,
+    BYTE* StringCount)
+{
+    PSMBIOS_TABLE NextTable;
+    const char* psz;
+    size_t MaxSize, Length;
+    BYTE Count;
+
+    /* Nothing could follow a malformed header or a formatted area cut by end of data */
+    if (Table->Header.Length < sizeof(SMBIOS_HEADER) || Table->Header.Length > SubPtr(Table, EndOfData))
+    {
+        *StringCount = 0;
+        return NULL;
+    }
+
+    psz = (const char*)AddPtr(Table, Table->Header.Length);
+    Count = 0;
+    NextTable = NULL;
+    while (true)
+    {
+        if (psz + 2 > (const char*)EndOfData)
+        {
+            break;
+        }
+        if (psz[0] == '\0' && psz[1] == '\0')
+        {
+            NextTable = (PSMBIOS_TABLE)(psz + 2);
+            break;
+        }
+
+        MaxSize = SubPtr(psz, EndOfData);
+        Length = strnlen(psz, MaxSize);
+        if (Length == MaxSize)
+        {
+            break;
+        }
+        if (Count < SMBIOS_MAX_STRINGS)
+        {
+            if (Strings != NULL)
+            {
+                Strings[Count] = psz;
+            }
+            Count++;
+        }
+        psz += Length + 1;
+        if (psz < (const char*)EndOfData && psz[0] == '\0')
+        {
+            NextTable = (PSMBIOS_TABLE)(psz + 1);
+            break;
+        }
+    }
+    if ((const void*)NextTable >= EndOfData)
+    {
+        NextTable = NULL;
+    }
+
+    *StringCount = Count;
+    return NextTable;
+}
+
+static int CompareIndexHandle(const void* A, const void* B)
+{
+    const SMBIOS_INDEX_HANDLE* p = (const SMBIOS_INDEX_HANDLE*)A;
+    const SMBIOS_INDEX_HANDLE* q = (const SMBIOS_INDEX_HANDLE*)B;
+
+    if (p->Handle != q->Handle)
+    {
+        return p->Handle < q->Handle ? -1 : 1;
+    }
+    return p->Entry < q->Entry ? -1 : (p->Entry > q->Entry ? 1 : 0);
+}
+
+bool
+SmbiosBuildIndex(
+    const void* TableData,
+    DWORD Length,
+    PSMBIOS_TABLE_INDEX Index)
+{
+    PSMBIOS_TABLE Table, NextTable;
+    const void* EndOfData;
+    SMBIOS_TABLE_SCAN Scan;
+    PSMBIOS_INDEX_ENTRY Entries, Entry;
+    DWORD Count, Capacity, i, Next[UCHAR_MAX + 1];
+    BYTE StringCount;
+    bool Sorted;
+
+    memset(Index, 0, sizeof(*Index));
+    Index->TableData = TableData;
+    EndOfData = AddPtr(TableData, Length);
+    if (!SmbiosScanTable(TableData, Length, &Scan))
+    {
+        return false;
+    }
+
+    /* Single walk over the table, record extents of each structure and count instances of each type */
+    Entries = NULL;
+    Count = Capacity = 0;
+    Table = (PSMBIOS_TABLE)TableData;
+    while (Table != NULL &&
+           SubPtr(Table, EndOfData) >= sizeof(SMBIOS_HEADER) &&
+           Table->Header.Length >= sizeof(SMBIOS_HEADER))
+    {
+        if (Count == Capacity)
+        {
+            Capacity = Capacity == 0 ? 64 : Capacity * 2;
+            Entry = (PSMBIOS_INDEX_ENTRY)realloc(Entries, Capacity * sizeof(SMBIOS_INDEX_ENTRY));
+            if (Entry == NULL)
+            {
+                goto _Fail;
+            }
+            Entries = Entry;
+        }
+        NextTable = SmbiosScanStructure(&Scan, Table, NULL, &StringCount);
+        Entry = &Entries[Count++];
+        Entry->Offset = SubPtr(TableData, Table);
+        Entry->Size = SubPtr(Table, NextTable == NULL ? EndOfData : (const void*)NextTable);
+        Entry->Handle = Table->Header.Handle;
+        Entry->Type = Table->Header.Type;
+        Entry->Length = Table->Header.Length <= Entry->Size ? Table->Header.Length : (BYTE)Entry->Size;
+        Entry->StringCount = StringCount;
+        Index->TypeStart[Entry->Type + 1]++;
+        Table = NextTable;
+    }
+    SmbiosFreeScan(&Scan);
+    Index->Entries = Entries;
+    Index->Count = Count;
+    if (Count == 0)
+    {
+        return true;
+    }
+
+    Index->Handles = (PSMBIOS_INDEX_HANDLE)malloc(Count * sizeof(SMBIOS_INDEX_HANDLE));
+    Index->ByType = (DWORD*)malloc(Count * sizeof(DWORD));
+    if (Index->Handles == NULL || Index->ByType == NULL)
+    {
+        goto _Fail;
+    }
+
+    /* Per-type instance lists, counting sort keeps table order within each type */
+    for (i = 1; i <= UCHAR_MAX + 1; i++)
+    {
+        Index->TypeStart[i] += Index->TypeStart[i - 1];
+    }
+    memcpy(Next, Index->TypeStart, sizeof(Next));
+    Sorted = true;
+    for (i = 0; i < Count; i++)
+    {
+        Index->ByType[Next[Entries[i].Type]++] = i;
+        Index->Handles[i].Handle = Entries[i].Handle;
+        Index->Handles[i].Entry = i;
+        if (i > 0 && Entries[i].Handle < Entries[i - 1].Handle)
+        {
+            Sorted = false;
+        }
+    }
+
+    /* Handles are usually assigned in ascending order by firmware */
+    if (!Sorted)
+    {
+        qsort(Index->Handles, Count, sizeof(SMBIOS_INDEX_HANDLE), CompareIndexHandle);
+    }
+    return true;
+
+_Fail:
+    SmbiosFreeScan(&Scan);
+    free(Entries);
+    Index->Entries = NULL;
+    SmbiosFreeIndex(Index);
+    return false;
+}
+
+void
+SmbiosFreeIndex(
+    PSMBIOS_TABLE_INDEX Index)
+{
+    free(Index->Entries);
+    free(Index->Handles);
+    free(Index->ByType);
+    memset(Index, 0, sizeof(*Index));
+}
+
+PSMBIOS_INDEX_ENTRY
+SmbiosIndexFindHandle(
+    const SMBIOS_TABLE_INDEX* Index,
+    WORD Handle)
+{
+    DWORD Low, High, Mid;
+
+    /* Lower bound, returns the first structure if handle is duplicated */
+    Low = 0;
+    High = Index->Count;
+    while (Low < High)
+    {
+        Mid = Low + (High - Low) / 2;
+        if (Index->Handles[Mid].Handle < Handle)
+        {
+            Low = Mid + 1;
+        } else
+        {
+            High = Mid;
+        }
+    }
+    if (Low == Index->Count || Index->Handles[Low].Handle != Handle)
+    {
+        return NULL;
+    }
+    return &Index->Entries[Index->Handles[Low].Entry];
+}
+
+DWORD
+SmbiosIndexTypeCount(
+    const SMBIOS_TABLE_INDEX* Index,
+    BYTE Type)
+{
+    return Index->TypeStart[Type + 1] - Index->TypeStart[Type];
+}
+
+PSMBIOS_INDEX_ENTRY
+SmbiosIndexGetType(
+    const SMBIOS_TABLE_INDEX* Index,
+    BYTE Type,
+    DWORD Instance)
+{
+    if (Instance >= SmbiosIndexTypeCount(Index, Type))
+    {
+        return NULL;
+    }
+    return &Index->Entries[Index->ByType[Index->TypeStart[Type] + Instance]];
+}
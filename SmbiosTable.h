@@ -0,0 +1,136 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+
+#define AddPtr(P, I) ((void*)((unsigned char*)(P) + (I))) // aka Add2Ptr
+#define SubPtr(B, O) ((unsigned int)((size_t)(O) - (size_t)(B))) // aka PtrOffset
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+/* Maximum number of strings could be referenced by a BYTE string field */
+#define SMBIOS_MAX_STRINGS UCHAR_MAX
+
+/*
+ * Walk string-set of a structure and locate the next structure.
+ *
+ * Strings receives start of each string if not NULL, capacity is SMBIOS_MAX_STRINGS.
+ * Returns the next structure, or NULL if this is the last one, the string-set is unterminated, Length is less than
+ * the header or goes past EndOfData.
+ */
+PSMBIOS_TABLE
+SmbiosWalkStructure(
+    PSMBIOS_TABLE Table,
+    const void* EndOfData,
+    const char** Strings,
+    BYTE* StringCount);
+
+#pragma region Structural Scan
+
+/*
+ * Two-stage structural scan: stage 1 builds a NUL bitmap of the whole table in one vectorized pass
+ * (SSE2, AVX2 or AVX-512BW, selected at runtime), stage 2 locates double-NUL terminators and string
+ * starts of each structure from the bitmap with bit operations instead of per-string scans.
+ */
+typedef struct _SMBIOS_TABLE_SCAN
+{
+    const void* TableData;
+    DWORD Length;
+    QWORD* NulBitmap;   // Bit N set if byte N is NUL, followed by a zero padding word
+} SMBIOS_TABLE_SCAN, *PSMBIOS_TABLE_SCAN;
+
+/* Stage 1, free with SmbiosFreeScan */
+bool
+SmbiosScanTable(
+    const void* TableData,
+    DWORD Length,
+    PSMBIOS_TABLE_SCAN Scan);
+
+void
+SmbiosFreeScan(
+    PSMBIOS_TABLE_SCAN Scan);
+
+/* Stage 2, same as SmbiosWalkStructure but uses the bitmap */
+PSMBIOS_TABLE
+SmbiosScanStructure(
+    const SMBIOS_TABLE_SCAN* Scan,
+    PSMBIOS_TABLE Table,
+    const char** Strings,
+    BYTE* StringCount);
+
+/*
+ * Offset of the first 16-byte boundary at or after Offset that starts with an entry point anchor ("_SM3", "_SM_"
+ * or "_DMI" as a candidate, not validated), Size if none. Vectorized the same as stage 1, for searching images of
+ * firmware or memory.
+ */
+size_t
+SmbiosScanAnchors(
+    const void* Data,
+    size_t Size,
+    size_t Offset);
+
+#pragma endregion
+
+#pragma region Table Index
+
+typedef struct _SMBIOS_INDEX_ENTRY
+{
+    DWORD Offset;       // Offset of structure in table data
+    DWORD Size;         // Formatted area and string-set in bytes, string-set starts at Offset + Length
+    WORD Handle;
+    BYTE Type;
+    BYTE Length;        // Length of formatted area, less than Header.Length if the table ends in it
+    BYTE StringCount;
+} SMBIOS_INDEX_ENTRY, *PSMBIOS_INDEX_ENTRY;
+
+typedef struct _SMBIOS_INDEX_HANDLE
+{
+    WORD Handle;
+    DWORD Entry;        // Index in Entries
+} SMBIOS_INDEX_HANDLE, *PSMBIOS_INDEX_HANDLE;
+
+typedef struct _SMBIOS_TABLE_INDEX
+{
+    const void* TableData;
+    DWORD Count;                    // Number of structures
+    PSMBIOS_INDEX_ENTRY Entries;    // Structures in table order // _Field_size_(Count)
+    PSMBIOS_INDEX_HANDLE Handles;   // Sorted by handle // _Field_size_(Count)
+    DWORD* ByType;                  // Entry indexes grouped by type, in table order within each type // _Field_size_(Count)
+    DWORD TypeStart[UCHAR_MAX + 2]; // Instances of type N are ByType[TypeStart[N]..TypeStart[N + 1]]
+} SMBIOS_TABLE_INDEX, *PSMBIOS_TABLE_INDEX;
+
+/* Walk the table once and build handle and type index, free with SmbiosFreeIndex */
+bool
+SmbiosBuildIndex(
+    const void* TableData,
+    DWORD Length,
+    PSMBIOS_TABLE_INDEX Index);
+
+void
+SmbiosFreeIndex(
+    PSMBIOS_TABLE_INDEX Index);
+
+PSMBIOS_INDEX_ENTRY
+SmbiosIndexFindHandle(
+    const SMBIOS_TABLE_INDEX* Index,
+    WORD Handle);
+
+DWORD
+SmbiosIndexTypeCount(
+    const SMBIOS_TABLE_INDEX* Index,
+    BYTE Type);
+
+PSMBIOS_INDEX_ENTRY
+SmbiosIndexGetType(
+    const SMBIOS_TABLE_INDEX* Index,
+    BYTE Type,
+    DWORD Instance);
+
+#define SmbiosIndexGetTable(Index, Entry) ((PSMBIOS_TABLE)AddPtr((Index)->TableData, (Entry)->Offset))
+#define SmbiosIndexGetStrings(Index, Entry) ((const char*)AddPtr((Index)->TableData, (Entry)->Offset + (Entry)->Length))
+
+#pragma endregion
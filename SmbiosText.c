@@ -0,0 +1,183 @@
+﻿#include "SmbiosText.h"
+
+static
+SMBIOS_VISIT_ACTION
+PrintTextStructure(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context)
+{
+    PSMBIOS_TEXT_WRITER Writer = (PSMBIOS_TEXT_WRITER)UserData;
+    PSMBIOS_TABLE Table = Context->Table;
+
+    /* Print table header */
+    SmbiosWriteString(Writer, "[Type ");
+    SmbiosWriteDecimal(Writer, Table->Header.Type, 0);
+    if (Context->TypeInfo != NULL)
+    {
+        SmbiosWriteString(Writer, ": ");
+        SmbiosWriteString(Writer, Context->TypeInfo->Name);
+        SmbiosWriteString(Writer, "]\n");
+    } else
+    {
+        SmbiosWriteString(Writer, " (Unrecognized)]\n");
+    }
+    SmbiosWriteString(Writer, "Handle: 0x");
+    SmbiosWriteHex(Writer, Table->Header.Handle, 4);
+    if (Context->PartialTable)
+    {
+        SmbiosWriteString(Writer, ", Offset: unknown");
+    } else
+    {
+        SmbiosWriteString(Writer, ", Offset: 0x");
+        SmbiosWriteHex(Writer, Context->Offset, 8);
+    }
+    SmbiosWriteString(Writer, ", Length: 0x");
+    SmbiosWriteHex(Writer, Table->Header.Length, 2);
+    SmbiosWriteString(Writer, " bytes, Total: 0x");
+    SmbiosWriteHex(Writer, Context->Size, 0);
+    SmbiosWriteString(Writer, " bytes\n");
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintTextStructureEnd(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context)
+{
+    SmbiosWriteChar((PSMBIOS_TEXT_WRITER)UserData, '\n');
+    return SmbiosVisitContinue;
+}
+
+static
+void
+PrintTextFieldName(
+    PSMBIOS_TEXT_WRITER Writer,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_FIELD_TYPE_INFO Field = Value->Field;
+
+    if (!Field->IsBitField)
+    {
+        SmbiosWriteString(Writer, "0x");
+        SmbiosWriteHex(Writer, Field->Offset, 4);
+        SmbiosWriteChar(Writer, ' ');
+        SmbiosWriteString(Writer, Field->Name);
+        SmbiosWriteString(Writer, ": ");
+        return;
+    }
+    SmbiosWriteChar(Writer, '\t');
+    if (Field->Type == SmbiosDataTypeBit)
+    {
+        SmbiosWriteDecimal(Writer, (BYTE)Field->Offset, 2);
+        SmbiosWriteString(Writer, Value->Value ? " [x] " : " [ ] ");
+        SmbiosWriteString(Writer, Field->Name);
+    } else if (Field->Type == SmbiosDataTypeUInt || Field->Type == SmbiosDataTypeEnum)
+    {
+        SmbiosWriteDecimal(Writer, (BYTE)Field->Offset, 2);
+        SmbiosWriteChar(Writer, ':');
+        SmbiosWriteDecimal(Writer, (BYTE)(Field->Offset + Field->Size - 1), 2);
+        SmbiosWriteChar(Writer, ' ');
+        SmbiosWriteString(Writer, Field->Name);
+        SmbiosWriteString(Writer, ": ");
+    }
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintTextString(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_TEXT_WRITER Writer = (PSMBIOS_TEXT_WRITER)UserData;
+
+    PrintTextFieldName(Writer, Value);
+    if (Value->String != NULL)
+    {
+        SmbiosWriteString(Writer, "0x");
+        SmbiosWriteHex(Writer, (BYTE)Value->Value, 2);
+        SmbiosWriteString(Writer, " \"");
+        SmbiosWriteString(Writer, Value->String);
+        SmbiosWriteChar(Writer, '"');
+    }
+    SmbiosWriteChar(Writer, '\n');
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintTextBit(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_TEXT_WRITER Writer = (PSMBIOS_TEXT_WRITER)UserData;
+
+    PrintTextFieldName(Writer, Value);
+    SmbiosWriteChar(Writer, '\n');
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+PrintTextField(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value)
+{
+    PSMBIOS_TEXT_WRITER Writer = (PSMBIOS_TEXT_WRITER)UserData;
+    PSMBIOS_FIELD_TYPE_INFO Field = Value->Field;
+
+    PrintTextFieldName(Writer, Value);
+    if (Field->Type == SmbiosDataTypeUInt || Field->Type == SmbiosDataTypeEnum)
+    {
+        if (Value->Size == sizeof(BYTE))
+        {
+            SmbiosWriteString(Writer, "0x");
+            SmbiosWriteHex(Writer, (BYTE)Value->Value, 2);
+        } else if (Value->Size == sizeof(WORD))
+        {
+            SmbiosWriteString(Writer, "0x");
+            SmbiosWriteHex(Writer, (WORD)Value->Value, 4);
+        } else if (Value->Size == sizeof(DWORD))
+        {
+            SmbiosWriteString(Writer, "0x");
+            SmbiosWriteHex(Writer, (DWORD)Value->Value, 8);
+        } else if (Value->Size == sizeof(QWORD))
+        {
+            SmbiosWriteString(Writer, "0x");
+            SmbiosWriteHex(Writer, Value->Value, 16);
+        }
+        if (Value->Enum != NULL)
+        {
+            SmbiosWriteString(Writer, " (");
+            SmbiosWriteString(Writer, (const char*)Value->Enum->Name);
+            SmbiosWriteChar(Writer, ')');
+        }
+    } else if (Field->IsBitField)
+    {
+        /* Only integers could be split into bits */
+    } else if (Field->Type == SmbiosDataTypeRaw || Field->Type == SmbiosDataTypeOther)
+    {
+        SmbiosWriteBytes(Writer, (const BYTE*)Value->Data, Field->Size);
+    } else if (Field->Type == SmbiosDataTypeUuid && Field->Size == 16)
+    {
+        SmbiosWriteUuid(Writer, (const BYTE*)Value->Data);
+    }
+    SmbiosWriteChar(Writer, '\n');
+    return SmbiosVisitContinue;
+}
+
+void
+SmbiosInitializeTextPrinter(
+    PSMBIOS_TEXT_WRITER Writer,
+    PSMBIOS_VISITOR Visitor)
+{
+    Visitor->UserData = Writer;
+    Visitor->OnStructure = PrintTextStructure;
+    Visitor->OnField = PrintTextField;
+    Visitor->OnString = PrintTextString;
+    Visitor->OnBit = PrintTextBit;
+    Visitor->OnStructureEnd = PrintTextStructureEnd;
+}
@@ -0,0 +1,13 @@
+﻿#pragma once
+
+#include "SmbiosVisit.h"
+#include "SmbiosWriter.h"
+
+/*
+ * Text output, a header of type, handle and size for each structure, then one line for each field as
+ * "0xOFFSET Name: Value" with bit fields indented below their integer, and an empty line after the structure.
+ */
+void
+SmbiosInitializeTextPrinter(
+    PSMBIOS_TEXT_WRITER Writer,
+    PSMBIOS_VISITOR Visitor);
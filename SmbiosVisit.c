@@ -0,0 +1,149 @@
+﻿#include "SmbiosVisit.h"
+
+#include <string.h>
+
+static
+PSMBIOS_FIELD_ENUM
+FindEnumValue(
+    PSMBIOS_FIELD_TYPE_INFO Field,
+    QWORD Value)
+{
+    WORD i;
+
+    for (i = 0; i < Field->AdditionalInfo.Enum.Count; i++)
+    {
+        if (Field->AdditionalInfo.Enum.Values[i].Value == Value)
+        {
+            return &Field->AdditionalInfo.Enum.Values[i];
+        }
+    }
+    return NULL;
+}
+
+void
+SmbiosLoadStepValue(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_DECODE_STEP* Step,
+    QWORD* Integer,
+    PSMBIOS_FIELD_VALUE Value)
+{
+    Value->Field = Step->Field;
+    Value->Data = AddPtr(Context->Table, Step->DataOffset);
+    Value->Size = Step->DataSize;
+    if (Step->Flags & SMBIOS_DECODE_STEP_LOAD)
+    {
+        *Integer = 0;
+        memcpy(Integer, Value->Data, Step->DataSize);
+    }
+    Value->Value = (*Integer >> Step->Shift) & Step->Mask;
+    Value->Enum = (Step->Flags & SMBIOS_DECODE_STEP_ENUM) ? FindEnumValue(Step->Field, Value->Value) : NULL;
+    Value->String = (Step->Flags & SMBIOS_DECODE_STEP_STRING) ? SmbiosGetString(Context, (BYTE)Value->Value) : NULL;
+}
+
+/* Generated visit functions of frequently decoded types */
+#include "SMBIOS.TypeDecode.h"
+
+static
+SMBIOS_VISIT_ACTION
+VisitPlan(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_VISITOR* Visitor)
+{
+    const SMBIOS_DECODE_PLAN* Plan = Context->Plan;
+    const SMBIOS_DECODE_STEP* Step;
+    const SMBIOS_DECODE_STEP* EndOfSteps;
+    SMBIOS_VISIT_FIELD_ROUTINE Routines[SmbiosDecodeStepKindCount];
+    SMBIOS_VISIT_ACTION Action;
+    SMBIOS_FIELD_VALUE Value;
+    QWORD Integer = 0;
+
+    Routines[SmbiosDecodeStepField] = Visitor->OnField;
+    Routines[SmbiosDecodeStepString] = Visitor->OnString;
+    Routines[SmbiosDecodeStepBit] = Visitor->OnBit;
+    EndOfSteps = Plan->Steps + SmbiosDecodePlanStepCount(Plan, Context->Length);
+    for (Step = Plan->Steps; Step < EndOfSteps; Step++)
+    {
+        SmbiosLoadStepValue(Context, Step, &Integer, &Value);
+        if (Routines[Step->Kind] != NULL)
+        {
+            Action = Routines[Step->Kind](Visitor->UserData, Context, &Value);
+            if (Action != SmbiosVisitContinue)
+            {
+                return Action;
+            }
+        }
+    }
+    return SmbiosVisitContinue;
+}
+
+static
+SMBIOS_VISIT_ACTION
+VisitStructure(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_VISITOR* Visitor)
+{
+    SMBIOS_COMPILED_VISIT_ROUTINE Compiled;
+    SMBIOS_VISIT_ACTION Action;
+
+    Action = Visitor->OnStructure != NULL ? Visitor->OnStructure(Visitor->UserData, Context) : SmbiosVisitContinue;
+    if (Action != SmbiosVisitContinue)
+    {
+        return Action;
+    }
+
+    if (Context->Plan != NULL)
+    {
+        if (Context->Plans->InterpretOnly || Context->Plan->Partial)
+        {
+            Compiled = NULL;
+        } else
+        {
+            Compiled = SmbiosCompiledVisitByType[Context->Table->Header.Type];
+        }
+        Action = Compiled != NULL ? Compiled(Context, Visitor) : VisitPlan(Context, Visitor);
+        if (Action == SmbiosVisitStop)
+        {
+            return Action;
+        }
+    }
+
+    return Visitor->OnStructureEnd != NULL ? Visitor->OnStructureEnd(Visitor->UserData, Context) : SmbiosVisitContinue;
+}
+
+SMBIOS_VISIT_ACTION
+SmbiosVisitStructure(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_VISITOR* Visitor)
+{
+    PSMBIOS_STATS Stats = Context->Stats;
+    SMBIOS_STAGE_TIMER Timer;
+    SMBIOS_VISIT_ACTION Action;
+
+    if (Stats == NULL)
+    {
+        return VisitStructure(Context, Visitor);
+    }
+    SmbiosStartStage(&Timer, Stats);
+    Action = VisitStructure(Context, Visitor);
+    if (Context->Plan != NULL && Action != SmbiosVisitSkip)
+    {
+        Stats->Fields += SmbiosDecodePlanStepCount(Context->Plan, Context->Length);
+    }
+    SmbiosEndStage(&Timer, SmbiosStageDecode);
+    return Action;
+}
+
+bool
+SmbiosVisitTable(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_VISITOR* Visitor)
+{
+    while (SmbiosNextStructure(Context))
+    {
+        if (SmbiosVisitStructure(Context, Visitor) == SmbiosVisitStop)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include "SmbiosContext.h"
+
+typedef enum _SMBIOS_VISIT_ACTION
+{
+    SmbiosVisitContinue,
+    SmbiosVisitSkip,    // Skip the rest of current structure
+    SmbiosVisitStop,    // Stop visiting the table
+} SMBIOS_VISIT_ACTION, *PSMBIOS_VISIT_ACTION;
+
+typedef struct _SMBIOS_FIELD_VALUE
+{
+    PSMBIOS_FIELD_TYPE_INFO Field;
+    const void* Data;               // Field data in structure, or the parent integer for bit fields
+    QWORD Value;                    // Integer, enumeration or bit value, or string index
+    WORD Size;                      // Size of integer in bytes, the parent integer for bit fields
+    PSMBIOS_FIELD_ENUM Enum;        // Matched enumeration value, NULL if not an enumeration or no match
+    const char* String;             // Resolved string, NULL if not a string or index is 0 or out of range
+} SMBIOS_FIELD_VALUE, *PSMBIOS_FIELD_VALUE;
+
+typedef
+SMBIOS_VISIT_ACTION
+(*SMBIOS_VISIT_STRUCTURE_ROUTINE)(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context);
+
+typedef
+SMBIOS_VISIT_ACTION
+(*SMBIOS_VISIT_FIELD_ROUTINE)(
+    void* UserData,
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_FIELD_VALUE* Value);
+
+/*
+ * Callbacks of walking a table driven by type information, any of them could be NULL.
+ *
+ * OnStructure: Each structure, return SmbiosVisitSkip to skip it without visiting fields or calling OnStructureEnd.
+ * OnField: Integer, enumeration, UUID and raw fields, including multi-bit fields.
+ * OnString: String fields.
+ * OnBit: Single bit fields.
+ * OnStructureEnd: After fields of a structure, unless skipped by OnStructure.
+ */
+typedef struct _SMBIOS_VISITOR
+{
+    void* UserData;
+    SMBIOS_VISIT_STRUCTURE_ROUTINE OnStructure;
+    SMBIOS_VISIT_FIELD_ROUTINE OnField;
+    SMBIOS_VISIT_FIELD_ROUTINE OnString;
+    SMBIOS_VISIT_FIELD_ROUTINE OnBit;
+    SMBIOS_VISIT_STRUCTURE_ROUTINE OnStructureEnd;
+} SMBIOS_VISITOR, *PSMBIOS_VISITOR;
+
+/*
+ * Value of a plan step of current structure, as visitors get it. Integer is the parent integer of bit fields,
+ * loaded by the last step with SMBIOS_DECODE_STEP_LOAD, so steps must be loaded in order from the first one.
+ */
+void
+SmbiosLoadStepValue(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_DECODE_STEP* Step,
+    QWORD* Integer,
+    PSMBIOS_FIELD_VALUE Value);
+
+/* Visit current structure of context, fields are visited only if the context has decode plans */
+SMBIOS_VISIT_ACTION
+SmbiosVisitStructure(
+    const SMBIOS_DECODE_CONTEXT* Context,
+    const SMBIOS_VISITOR* Visitor);
+
+/* Visit the rest structures of context, returns false if stopped by visitor */
+bool
+SmbiosVisitTable(
+    PSMBIOS_DECODE_CONTEXT Context,
+    const SMBIOS_VISITOR* Visitor);
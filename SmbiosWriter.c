@@ -0,0 +1,255 @@
+﻿#include "SmbiosWriter.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char HexDigits[] = "0123456789ABCDEF";
+
+/* Longest run written at once by formatting routines: 64-bit decimal, or padding of up to 255 digits */
+#define WRITER_RESERVE_SIZE (UCHAR_MAX + 1)
+
+/* Write buffer to file and empty it, and flush the file too with Flush */
+static
+void
+WriteBuffer(
+    PSMBIOS_TEXT_WRITER Writer,
+    bool Flush)
+{
+    SMBIOS_STAGE_TIMER Timer;
+
+    SmbiosStartStage(&Timer, Writer->Stats);
+    if (Writer->Used != 0 && fwrite(Writer->Buffer, 1, Writer->Used, Writer->File) != Writer->Used)
+    {
+        Writer->Failed = true;
+    }
+    if (Flush && fflush(Writer->File) != 0)
+    {
+        Writer->Failed = true;
+    }
+    if (Writer->Stats != NULL)
+    {
+        Writer->Stats->BytesWritten += Writer->Used;
+    }
+    SmbiosEndStage(&Timer, SmbiosStageOutput);
+    Writer->Used = 0;
+}
+
+bool
+SmbiosInitializeWriter(
+    PSMBIOS_TEXT_WRITER Writer,
+    FILE* File,
+    size_t Size)
+{
+    if (Size < WRITER_RESERVE_SIZE)
+    {
+        Size = Size == 0 ? SMBIOS_WRITER_BUFFER_SIZE : WRITER_RESERVE_SIZE;
+    }
+    Writer->File = File;
+    Writer->Size = Size;
+    Writer->Used = 0;
+    Writer->Failed = false;
+    Writer->Stats = NULL;
+    Writer->Buffer = (char*)malloc(Size);
+    return Writer->Buffer != NULL;
+}
+
+bool
+SmbiosUninitializeWriter(
+    PSMBIOS_TEXT_WRITER Writer)
+{
+    bool Result;
+
+    Result = SmbiosFlushWriter(Writer);
+    free(Writer->Buffer);
+    memset(Writer, 0, sizeof(*Writer));
+    return Result;
+}
+
+bool
+SmbiosFlushWriter(
+    PSMBIOS_TEXT_WRITER Writer)
+{
+    if (Writer->File == NULL)
+    {
+        return !Writer->Failed;
+    }
+    WriteBuffer(Writer, true);
+    return !Writer->Failed;
+}
+
+/* Grow memory buffer by double, drop the output if failed so writing can go on */
+static
+void
+Grow(
+    PSMBIOS_TEXT_WRITER Writer,
+    size_t Size)
+{
+    size_t NewSize;
+    char* NewBuffer;
+
+    NewSize = Writer->Size * 2;
+    if (NewSize - Writer->Used < Size)
+    {
+        NewSize = Writer->Used + Size;
+    }
+    NewBuffer = (char*)realloc(Writer->Buffer, NewSize);
+    if (NewBuffer == NULL)
+    {
+        Writer->Failed = true;
+        Writer->Used = 0;
+        return;
+    }
+    Writer->Buffer = NewBuffer;
+    Writer->Size = NewSize;
+}
+
+/* Make sure Size bytes can be appended to buffer, Size is no more than WRITER_RESERVE_SIZE */
+static
+char*
+Reserve(
+    PSMBIOS_TEXT_WRITER Writer,
+    size_t Size)
+{
+    if (Writer->Size - Writer->Used < Size)
+    {
+        if (Writer->File == NULL)
+        {
+            Grow(Writer, Size);
+            return Writer->Buffer + Writer->Used;
+        }
+        WriteBuffer(Writer, false);
+    }
+    return Writer->Buffer + Writer->Used;
+}
+
+void
+SmbiosWriteChar(
+    PSMBIOS_TEXT_WRITER Writer,
+    char c)
+{
+    *Reserve(Writer, 1) = c;
+    Writer->Used++;
+}
+
+void
+SmbiosWriteString(
+    PSMBIOS_TEXT_WRITER Writer,
+    const char* String)
+{
+    SmbiosWriteText(Writer, String, strlen(String));
+}
+
+void
+SmbiosWriteText(
+    PSMBIOS_TEXT_WRITER Writer,
+    const char* Text,
+    size_t Length)
+{
+    size_t Chunk;
+
+    while (Length != 0)
+    {
+        Chunk = Writer->Size - Writer->Used;
+        if (Chunk == 0)
+        {
+            Reserve(Writer, 1);
+            Chunk = Writer->Size - Writer->Used;
+        }
+        if (Chunk > Length)
+        {
+            Chunk = Length;
+        }
+        memcpy(Writer->Buffer + Writer->Used, Text, Chunk);
+        Writer->Used += Chunk;
+        Text += Chunk;
+        Length -= Chunk;
+    }
+}
+
+void
+SmbiosWriteHex(
+    PSMBIOS_TEXT_WRITER Writer,
+    QWORD Value,
+    BYTE MinDigits)
+{
+    BYTE Digits;
+    char* p;
+
+    /* Count significant digits, at least one for zero */
+    for (Digits = 1; Digits < 16 && (Value >> (Digits * 4)) != 0; Digits++);
+    if (Digits < MinDigits)
+    {
+        Digits = MinDigits;
+    }
+    p = Reserve(Writer, Digits);
+    Writer->Used += Digits;
+    while (Digits != 0)
+    {
+        p[--Digits] = HexDigits[Value & 0xF];
+        Value >>= 4;
+    }
+}
+
+void
+SmbiosWriteDecimal(
+    PSMBIOS_TEXT_WRITER Writer,
+    QWORD Value,
+    BYTE MinDigits)
+{
+    char Text[20];
+    BYTE Digits, i;
+    char* p;
+
+    Digits = 0;
+    do
+    {
+        Text[sizeof(Text) - ++Digits] = (char)('0' + Value % 10);
+        Value /= 10;
+    } while (Value != 0);
+    i = Digits < MinDigits ? MinDigits - Digits : 0;
+    p = Reserve(Writer, i + Digits);
+    Writer->Used += i + Digits;
+    memset(p, '0', i);
+    memcpy(p + i, Text + sizeof(Text) - Digits, Digits);
+}
+
+void
+SmbiosWriteBytes(
+    PSMBIOS_TEXT_WRITER Writer,
+    const BYTE* Data,
+    size_t Size)
+{
+    size_t i;
+    char* p;
+
+    for (i = 0; i < Size; i++)
+    {
+        p = Reserve(Writer, 3);
+        p[0] = HexDigits[Data[i] >> 4];
+        p[1] = HexDigits[Data[i] & 0xF];
+        p[2] = ' ';
+        Writer->Used += i != Size - 1 ? 3 : 2;
+    }
+}
+
+void
+SmbiosWriteUuid(
+    PSMBIOS_TEXT_WRITER Writer,
+    const BYTE* Uuid)
+{
+    BYTE i;
+    char* p;
+
+    p = Reserve(Writer, 36);
+    Writer->Used += 36;
+    for (i = 0; i < 16; i++)
+    {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+        {
+            *p++ = '-';
+        }
+        *p++ = HexDigits[Uuid[i] >> 4];
+        *p++ = HexDigits[Uuid[i] & 0xF];
+    }
+}
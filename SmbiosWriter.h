@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include "SMBIOS.h"
+#include "SmbiosStats.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define SMBIOS_WRITER_BUFFER_SIZE   0x10000
+
+/*
+ * Buffered text output, formatting is done by hand into the buffer which is written to the file only
+ * when full or flushed, instead of going through stdio for every field.
+ * Without file, the buffer grows to hold all output (Buffer[0..Used]) until uninitialized.
+ */
+typedef struct _SMBIOS_TEXT_WRITER
+{
+    FILE* File;                     // NULL to keep output in memory
+    char* Buffer;                   // _Field_size_(Size)
+    size_t Size;
+    size_t Used;
+    bool Failed;                    // Any write to file or growing buffer failed
+    PSMBIOS_STATS Stats;            // NULL, or set after initializing to add time and bytes written to file
+} SMBIOS_TEXT_WRITER, *PSMBIOS_TEXT_WRITER;
+
+/* Size 0 for SMBIOS_WRITER_BUFFER_SIZE, or initial size if File is NULL */
+bool
+SmbiosInitializeWriter(
+    PSMBIOS_TEXT_WRITER Writer,
+    FILE* File,
+    size_t Size);
+
+/* Flush and free buffer, returns false if any write failed */
+bool
+SmbiosUninitializeWriter(
+    PSMBIOS_TEXT_WRITER Writer);
+
+bool
+SmbiosFlushWriter(
+    PSMBIOS_TEXT_WRITER Writer);
+
+void
+SmbiosWriteChar(
+    PSMBIOS_TEXT_WRITER Writer,
+    char c);
+
+void
+SmbiosWriteString(
+    PSMBIOS_TEXT_WRITER Writer,
+    const char* String);
+
+void
+SmbiosWriteText(
+    PSMBIOS_TEXT_WRITER Writer,
+    const char* Text,
+    size_t Length);
+
+/* Upper case hex without prefix, zero padded to at least MinDigits, like "%0*llX" */
+void
+SmbiosWriteHex(
+    PSMBIOS_TEXT_WRITER Writer,
+    QWORD Value,
+    BYTE MinDigits);
+
+/* Zero padded to at least MinDigits, like "%0*llu" */
+void
+SmbiosWriteDecimal(
+    PSMBIOS_TEXT_WRITER Writer,
+    QWORD Value,
+    BYTE MinDigits);
+
+/* Bytes in upper case hex separated by spaces */
+void
+SmbiosWriteBytes(
+    PSMBIOS_TEXT_WRITER Writer,
+    const BYTE* Data,
+    size_t Size);
+
+/* 16 bytes in 8-4-4-4-12 form as stored, without swapping byte order */
+void
+SmbiosWriteUuid(
+    PSMBIOS_TEXT_WRITER Writer,
+    const BYTE* Uuid);
@@ -120,6 +120,8 @@ static String AddStructureType(String TypeNumber, String StructureName)
     }
     Output.Write("\r\n\r\n"u8.ToArray());
     Structures.Add(StructureName, StructureTypeName);
+    Fields.Reverse();
+    StructureFields.Add(StructureTypeName, Fields);
 
     return StructureTypeName;
 }
@@ -404,6 +406,8 @@ for (UInt32 i = 1; i < Data.Length; i++)
 
 _AddType:
     TypeDef.HasDefination = Fields.Count > 0;
+    Fields.Reverse();
+    TypeDef.Fields = Fields;
     Types.Add(TypeDef);
     InTypeRegion = false;
 }
@@ -421,8 +425,88 @@ foreach (var Type in Types)
 }
 Output.Write("};\r\n"u8.ToArray());
 
+/* Direct lookup table indexed by type number */
+Dictionary<Int32, Int32> TypeIndexes = [];
+for (Int32 i = 0; i < Types.Count; i++)
+{
+    TypeIndexes.TryAdd(Int32.Parse(Types[i].Number), i);
+}
+Output.Write("\r\nSMBIOS_TYPEINFO_SELECTANY\r\nPSMBIOS_TYPE_INFO SmbiosTypeInfoByType[256] = {\r\n"u8.ToArray());
+for (Int32 i = 0; i < 256; i++)
+{
+    if (TypeIndexes.TryGetValue(i, out var TypeIndex))
+    {
+        Output.Write(Encoding.UTF8.GetBytes("    &SmbiosTypeInfo[" + TypeIndex.ToString() + "], // " + i.ToString() + "\r\n"));
+    } else
+    {
+        Output.Write(Encoding.UTF8.GetBytes("    NULL, // " + i.ToString() + "\r\n"));
+    }
+}
+Output.Write("};\r\n"u8.ToArray());
+
 Output.Dispose();
 
+/* Optional specialized visit functions of types given after input file */
+if (args.Length > 1)
+{
+    HashSet<String> CompileTypes = [.. args[1..]], CompiledTypes = [];
+
+    Output = File.Create(Path.ChangeExtension(InputFile, "TypeDecode.h"));
+    Output.Write(Utf8Bom);
+    Output.Write(Encoding.UTF8.GetBytes(Encoding.UTF8.GetString(Head).Replace("#include \"SMBIOS.TypeInfo.inl\"", "#include \"SmbiosCompiled.h\"")));
+    foreach (var Type in Types)
+    {
+        if (!Type.HasDefination || !CompileTypes.Remove(Type.Number))
+        {
+            continue;
+        }
+        CompiledTypes.Add(Type.Number);
+        Output.Write(Encoding.UTF8.GetBytes("SMBIOS_DEFINE_COMPILED_VISIT(" + Type.Number + ")\r\n{\r\n    SMBIOS_COMPILED_VISIT_BEGIN(" + Type.Number + ");\r\n"));
+        List<String> Fields = ExpandFields(Type.Fields);
+        for (Int32 i = 0; i < Fields.Count; i++)
+        {
+            Output.Write(Encoding.UTF8.GetBytes("    " + RxDefineMacro().Replace(Fields[i], "SMBIOS_DECODE_$1(" + i.ToString() + ", ", 1) + ";\r\n"));
+        }
+        Output.Write("    SMBIOS_COMPILED_VISIT_END();\r\n}\r\n\r\n"u8.ToArray());
+    }
+    foreach (var Type in CompileTypes)
+    {
+        Console.WriteLine("Type " + Type + " has no field to compile");
+    }
+
+    Output.Write("static const SMBIOS_COMPILED_VISIT_ROUTINE SmbiosCompiledVisitByType[256] = {\r\n"u8.ToArray());
+    for (Int32 i = 0; i < 256; i++)
+    {
+        if (CompiledTypes.Contains(i.ToString()))
+        {
+            Output.Write(Encoding.UTF8.GetBytes("    SmbiosCompiledVisitType" + i.ToString() + ", // " + i.ToString() + "\r\n"));
+        } else
+        {
+            Output.Write(Encoding.UTF8.GetBytes("    NULL, // " + i.ToString() + "\r\n"));
+        }
+    }
+    Output.Write("};\r\n"u8.ToArray());
+    Output.Dispose();
+}
+
+/* Replace nested structure macros with their fields, so each entry is one element of SmbiosTypeNFieldInfo */
+static List<String> ExpandFields(List<String> Fields)
+{
+    List<String> Result = [];
+
+    foreach (String Field in Fields)
+    {
+        if (StructureFields.TryGetValue(Field, out var Members))
+        {
+            Result.AddRange(ExpandFields(Members));
+        } else
+        {
+            Result.Add(Field);
+        }
+    }
+    return Result;
+}
+
 partial class Program
 {
     [GeneratedRegex(@"#pragma region (.+) \(Type (\d+).+", RegexOptions.Compiled)]
@@ -437,14 +521,19 @@ partial class Program
     [GeneratedRegex(@"#define (SMBIOS_\w+) +\(\S+\) // (.+)", RegexOptions.Compiled)]
     private static partial Regex RxEnumDefine();
 
+    [GeneratedRegex(@"^SMBIOS_DEFINE_(\w+)\(", RegexOptions.Compiled)]
+    private static partial Regex RxDefineMacro();
+
     private static FileStream Output;
     private static String[] Data = [];
     private static readonly Dictionary<String, String> Enums = [];
     private static readonly Dictionary<String, String> Structures = [];
+    private static readonly Dictionary<String, List<String>> StructureFields = [];
     private struct SmbiosType
     {
         public String Number;
         public String Name;
         public Boolean HasDefination;
+        public List<String> Fields;
     }
 }